@@ -0,0 +1,47 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "include/allocations.h"
+
+// Replaces the global operator new to count allocations; every other form of new and delete ends up in these.
+
+static std::atomic<size_t> Allocations{0};
+
+size_t
+allocation_count() noexcept {
+    return Allocations.load(std::memory_order_relaxed);
+}
+
+void *
+operator new(const std::size_t size) {
+    Allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void *
+operator new[](const std::size_t size) {
+    return operator new(size);
+}
+
+void
+operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void
+operator delete[](void *memory) noexcept {
+    std::free(memory);
+}
+
+void
+operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void
+operator delete[](void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
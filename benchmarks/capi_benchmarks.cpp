@@ -0,0 +1,137 @@
+#include <benchmark/benchmark.h>
+#include <baybayin-core/capi.h>
+#include <spawn.h>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "include/allocations.h"
+#include "include/inputs.h"
+
+// The C API against the way a program without it would get the same result: tl --normalize run on the text, written
+// to its stdin and read back from its stdout. Both normalize English Taglish.
+
+extern char **environ;
+
+static const Inputs Texts("computer", TaglishText);
+
+static baybayin_engine *
+make_engine() {
+    baybayin_config config;
+    baybayin_config_init(&config);
+    config.language = BAYBAYIN_ENGLISH;
+    baybayin_engine *engine = nullptr;
+    baybayin_engine_create(&config, &engine);
+    return engine;
+}
+
+static void
+BM_Ffi(benchmark::State &state) {
+    const std::string &input = Texts[state.range(0)];
+    baybayin_engine *engine = make_engine();
+    std::vector<char> output(baybayin_normalize_transliterate_bound(engine, input.size()));
+    size_t size = 0;
+    // the first call grows the engine's buffers
+    baybayin_normalize_transliterate(engine, input.data(), input.size(), output.data(), output.size(), &size);
+    const size_t allocations = allocation_count();
+    for (auto _ : state) {
+        baybayin_normalize_transliterate(engine, input.data(), input.size(), output.data(), output.size(), &size);
+        benchmark::DoNotOptimize(output.data());
+    }
+    set_allocations(state, allocations);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+    baybayin_engine_destroy(engine);
+}
+
+BENCHMARK(BM_Ffi)->Apply(input_arg);
+
+// The document's lines as one batch
+static void
+BM_FfiBatch(benchmark::State &state) {
+    const std::string &input = Texts.document;
+    std::vector<size_t> input_offsets{0};
+    for (size_t end = input.find('\n'); end != std::string::npos; end = input.find('\n', end + 1)) {
+        input_offsets.push_back(end + 1);
+    }
+    const size_t count = input_offsets.size() - 1;
+    baybayin_engine *engine = make_engine();
+    std::vector<char> output(baybayin_normalize_transliterate_bound(engine, input_offsets.back()));
+    std::vector<size_t> output_offsets(count + 1);
+    baybayin_normalize_transliterate_batch(engine, input.data(), input_offsets.data(), count, output.data(),
+                                           output.size(), output_offsets.data());
+    const size_t allocations = allocation_count();
+    for (auto _ : state) {
+        baybayin_normalize_transliterate_batch(engine, input.data(), input_offsets.data(), count, output.data(),
+                                               output.size(), output_offsets.data());
+        benchmark::DoNotOptimize(output.data());
+    }
+    set_allocations(state, allocations);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input_offsets.back()));
+    baybayin_engine_destroy(engine);
+}
+
+BENCHMARK(BM_FfiBatch);
+
+// Runs tl on input, returning what it wrote
+static std::string
+pipe_through_tl(const std::string &input) {
+    int in[2];
+    int out[2];
+    if (pipe(in) != 0 || pipe(out) != 0) {
+        return {};
+    }
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, in[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+    for (const int fd : {in[0], in[1], out[0], out[1]}) {
+        posix_spawn_file_actions_addclose(&actions, fd);
+    }
+    char tl[] = BAYBAYIN_TL;
+    char normalize[] = "--normalize";
+    char language[] = "--language";
+    char english[] = "english";
+    char *argv[] = {tl, normalize, language, english, nullptr};
+    pid_t pid;
+    const bool spawned = posix_spawn(&pid, tl, &actions, nullptr, argv, environ) == 0;
+    posix_spawn_file_actions_destroy(&actions);
+    close(in[0]);
+    close(out[1]);
+    std::string result;
+    if (spawned) {
+        // written from a thread, so neither side blocks on a full pipe
+        std::thread writer([&] {
+            for (size_t written = 0; written < input.size();) {
+                const ssize_t n = write(in[1], input.data() + written, input.size() - written);
+                if (n <= 0) {
+                    break;
+                }
+                written += static_cast<size_t>(n);
+            }
+            close(in[1]);
+        });
+        char buffer[1 << 16];
+        for (ssize_t n; (n = read(out[0], buffer, sizeof(buffer))) > 0;) {
+            result.append(buffer, static_cast<size_t>(n));
+        }
+        writer.join();
+        waitpid(pid, nullptr, 0);
+    } else {
+        close(in[1]);
+    }
+    close(out[0]);
+    return result;
+}
+
+static void
+BM_CliPipe(benchmark::State &state) {
+    const std::string &input = Texts[state.range(0)];
+    for (auto _ : state) {
+        auto output = pipe_through_tl(input);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+BENCHMARK(BM_CliPipe)->Apply(input_arg)->UseRealTime();
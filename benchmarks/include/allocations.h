@@ -0,0 +1,18 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+
+// Heap allocations made so far by the process, counted by the global operator new in allocations.cpp
+size_t
+allocation_count() noexcept;
+
+/**
+ * @name set_allocations
+ * @brief Reports the allocations made since start as the allocs counter, averaged per iteration.
+ */
+inline void
+set_allocations(benchmark::State &state, const size_t start) {
+    state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocation_count() - start),
+                                                  benchmark::Counter::kAvgIterations);
+}
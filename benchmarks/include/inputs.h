@@ -0,0 +1,60 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// The inputs the benchmarks run over: a single word, one sentence and a document of a few megabytes, so per-call
+// overhead and throughput on bulk text are both tracked.
+
+// examples/tagalog.txt
+inline constexpr std::string_view TagalogText =
+"Ang pangalan ko ay Inday. Taga-Maynila ako. Ang paboritong kong kulay ay dilaw. Kasi nga dilaw ang paborito "
+"kong kulay, meron akong dilaw na palda. At gustong-gusto ko ang mga dilaw na bulaklak. Para sa akin, ang dilaw "
+"ang kulay ng buhay.\n";
+
+// Taglish, so the normalizer has loanwords to rewrite
+inline constexpr std::string_view TaglishText =
+"Ang pangalan ko ay Inday. Taga-Maynila ako at nag-aaral ng computer science sa university. Kasi nga dilaw "
+"ang paborito kong kulay, meron akong yellow na jacket. Mga phone at laptop ang dala ko sa office tuwing "
+"Friday, pero ang favorite ko ay ang chocolate cake ni Lola.\n";
+
+inline constexpr size_t DocumentSize = 4 << 20;
+
+inline std::string
+make_document(const std::string_view text, const size_t size) {
+    std::string document;
+    document.reserve(size + text.size());
+    while (document.size() < size) {
+        document.append(text);
+    }
+    return document;
+}
+
+/**
+ * @name Inputs
+ * @brief A word, the first sentence of text and a document of text repeated, indexed by the input argument.
+ */
+struct Inputs {
+    std::string word;
+    std::string sentence;
+    std::string document;
+
+    Inputs(const std::string_view word, const std::string_view text)
+    : word(word), sentence(text.substr(0, text.find('.') + 1)), document(make_document(text, DocumentSize)) {
+    }
+
+    [[nodiscard]] const std::string &
+    operator[](const int64_t input) const {
+        return input == 0 ? word : input == 1 ? sentence : document;
+    }
+};
+
+inline constexpr int64_t InputCount = 3;
+
+// Registers the input argument, by name
+inline void
+input_arg(benchmark::internal::Benchmark *benchmark) {
+    benchmark->ArgName("input")->DenseRange(0, InputCount - 1);
+}
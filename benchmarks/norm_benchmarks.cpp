@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+#include <baybayin-core/norm.h>
+#include <string>
+#include "include/allocations.h"
+#include "include/inputs.h"
+
+static const Inputs Texts("computer", TaglishText);
+
+// language, latin orthography, diphthongs and clusters, each 0 or 1, then the input
+static void
+settings_args(benchmark::internal::Benchmark *benchmark) {
+    benchmark->ArgNames({"english", "alpabetong", "reformed_diphthong", "reformed_cluster", "input"})
+             ->ArgsProduct({{0, 1}, {0, 1}, {0, 1}, {0, 1}, {0, 1, 2}});
+}
+
+// The two pass reference
+static void
+BM_Normalizer(benchmark::State &state) {
+    const auto language = static_cast<phil_norm::ForeignLanguage>(state.range(0));
+    const auto orthography = static_cast<phil_norm::LatinOrthography>(state.range(1));
+    const auto diphthongs = static_cast<phil_norm::Diphthong>(state.range(2));
+    const auto clusters = static_cast<phil_norm::InitialCluster>(state.range(3));
+    const std::string &input = Texts[state.range(4)];
+    const size_t allocations = allocation_count();
+    for (auto _ : state) {
+        auto out = phil_norm::normalizer(input, language, orthography, diphthongs, clusters);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_allocations(state, allocations);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+BENCHMARK(BM_Normalizer)->Apply(settings_args);
+
+static void
+BM_FastNormalizer(benchmark::State &state) {
+    const auto language = static_cast<phil_norm::ForeignLanguage>(state.range(0));
+    const auto orthography = static_cast<phil_norm::LatinOrthography>(state.range(1));
+    const auto diphthongs = static_cast<phil_norm::Diphthong>(state.range(2));
+    const auto clusters = static_cast<phil_norm::InitialCluster>(state.range(3));
+    const std::string &input = Texts[state.range(4)];
+    std::string out;
+    const size_t allocations = allocation_count();
+    for (auto _ : state) {
+        out.clear();
+        phil_norm::fast_normalizer(input, out, language, orthography, diphthongs, clusters);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_allocations(state, allocations);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+BENCHMARK(BM_FastNormalizer)->Apply(settings_args);
+
+// The consonant pass alone
+static void
+BM_ConsonantNormalize(benchmark::State &state) {
+    const auto language = static_cast<phil_norm::ForeignLanguage>(state.range(0));
+    const auto orthography = static_cast<phil_norm::LatinOrthography>(state.range(1));
+    const std::string &input = Texts[state.range(2)];
+    std::string out;
+    const size_t allocations = allocation_count();
+    for (auto _ : state) {
+        out.clear();
+        consonant_normalize_dispatch(input, out, language, orthography);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_allocations(state, allocations);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+BENCHMARK(BM_ConsonantNormalize)->ArgNames({"english", "alpabetong", "input"})
+                                ->ArgsProduct({{0, 1}, {0, 1}, {0, 1, 2}});
+
+// The vowel pass alone, over the output of the consonant pass as normalizer runs it
+static void
+BM_VowelNormalize(benchmark::State &state) {
+    const auto language = static_cast<phil_norm::ForeignLanguage>(state.range(0));
+    const auto orthography = static_cast<phil_norm::LatinOrthography>(state.range(1));
+    const auto diphthongs = static_cast<phil_norm::Diphthong>(state.range(2));
+    const auto clusters = static_cast<phil_norm::InitialCluster>(state.range(3));
+    std::string input;
+    consonant_normalize_dispatch(Texts[state.range(4)], input, language, orthography);
+    std::string out;
+    const size_t allocations = allocation_count();
+    for (auto _ : state) {
+        out.clear();
+        vowel_normalize_dispatch(input, out, language, orthography, diphthongs, clusters);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_allocations(state, allocations);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+BENCHMARK(BM_VowelNormalize)->Apply(settings_args);
+
+// One indirect call through DispatchTable against calling the same configuration directly, on a word short enough
+// for the call to show
+static void
+BM_Dispatch(benchmark::State &state) {
+    const auto language = static_cast<phil_norm::ForeignLanguage>(state.range(0));
+    const auto clusters = static_cast<phil_norm::InitialCluster>(state.range(1));
+    const bool direct = state.range(2) != 0;
+    const std::string_view input = "plano";
+    std::string out;
+    std::string stage;
+    for (auto _ : state) {
+        out.clear();
+        if (direct) {
+            FastNormalizeEntry<phil_norm::ForeignLanguage::ENGLISH, phil_norm::LatinOrthography::ABAKADA,
+                               phil_norm::InitialCluster::REFORMED>::run(input, out, stage, {});
+        } else {
+            fast_normalize_dispatch(input, out, stage, language, phil_norm::LatinOrthography::ABAKADA,
+                                    phil_norm::Diphthong::REFORMED, clusters);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+BENCHMARK(BM_Dispatch)->ArgNames({"english", "reformed_cluster", "direct"})
+                      ->Args({1, 1, 0})->Args({1, 1, 1});
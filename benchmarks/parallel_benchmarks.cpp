@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include <baybayin-core/tl.h>
+#include <baybayin-core/util/parallel.h>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include "include/allocations.h"
+#include "include/inputs.h"
+
+using namespace baybayin;
+
+// Discards its output, so only the processing is measured
+class NullBuffer : public std::streambuf {
+protected:
+    std::streamsize
+    xsputn(const char *, const std::streamsize count) override {
+        return count;
+    }
+
+    int_type
+    overflow(const int_type c) override {
+        return traits_type::not_eof(c);
+    }
+};
+
+static const std::string &
+large_document() {
+    static const std::string Document = make_document(TagalogText, 64 << 20);
+    return Document;
+}
+
+// Scaling with the number of workers over 64 MiB read from a stream, wall clock time
+static void
+BM_Threads(benchmark::State &state) {
+    const std::string &document = large_document();
+    const auto threads = static_cast<size_t>(state.range(0));
+    NullBuffer discard;
+    std::ostream ostream(&discard);
+    const size_t allocations = allocation_count();
+    for (auto _ : state) {
+        std::istringstream istream(document);
+        process_lines_parallel(istream, ostream, threads, [] {
+            return [](const std::string_view line, std::string &out) { latin_to_baybayin(line, out); };
+        });
+    }
+    set_allocations(state, allocations);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * document.size()));
+}
+
+BENCHMARK(BM_Threads)->ArgName("threads")->RangeMultiplier(2)->Range(1, 2 * std::thread::hardware_concurrency())
+                     ->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// The same over text already in memory, as a mapped file is: the workers read their lines in place
+static void
+BM_ThreadsInMemory(benchmark::State &state) {
+    const std::string &document = large_document();
+    const auto threads = static_cast<size_t>(state.range(0));
+    const size_t allocations = allocation_count();
+    for (auto _ : state) {
+        process_lines_parallel(std::string_view(document), [](const std::string &output) {
+            benchmark::DoNotOptimize(output.data());
+            return true;
+        }, threads, [] {
+            return [](const std::string_view line, std::string &out) { latin_to_baybayin(line, out); };
+        });
+    }
+    set_allocations(state, allocations);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * document.size()));
+}
+
+BENCHMARK(BM_ThreadsInMemory)->ArgName("threads")->RangeMultiplier(2)->Range(1, 2 * std::thread::hardware_concurrency())
+                             ->UseRealTime()->Unit(benchmark::kMillisecond);
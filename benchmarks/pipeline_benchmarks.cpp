@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+#include <baybayin-core/pipeline.h>
+#include <string>
+#include "include/allocations.h"
+#include "include/inputs.h"
+
+using namespace baybayin;
+
+static const std::string Document = make_document(TaglishText, DocumentSize);
+
+// normalizer then latin_to_baybayin, three strings
+static void
+BM_TwoSteps(benchmark::State &state) {
+    const size_t allocations = allocation_count();
+    for (auto _ : state) {
+        const auto normalized = phil_norm::normalizer(Document, ForeignLanguage::ENGLISH, LatinOrthography::ABAKADA,
+                                                      Diphthong::REFORMED, InitialCluster::REFORMED);
+        auto out = latin_to_baybayin(normalized);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_allocations(state, allocations);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * Document.size()));
+}
+
+BENCHMARK(BM_TwoSteps);
+
+static void
+BM_Fused(benchmark::State &state) {
+    NormalizingTransliterator pipeline(ForeignLanguage::ENGLISH, LatinOrthography::ABAKADA, Diphthong::REFORMED,
+                                       InitialCluster::REFORMED);
+    std::string out;
+    const size_t allocations = allocation_count();
+    for (auto _ : state) {
+        out.clear();
+        pipeline.transliterate(Document, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_allocations(state, allocations);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * Document.size()));
+}
+
+BENCHMARK(BM_Fused);
@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <baybayin-core/tl.h>
+#include <string>
+#include <vector>
+#include "include/allocations.h"
+#include "include/inputs.h"
+
+using namespace baybayin;
+
+static const Inputs Texts("pagmamahal", TagalogText);
+static const std::string &Document = Texts.document;
+
+// Orthography and Virama are runtime arguments, dispatched once per call, over a word, a sentence and a document
+static void
+BM_Runtime(benchmark::State &state) {
+    const auto ortho = static_cast<Orthography>(state.range(0));
+    const auto style = static_cast<Virama>(state.range(1));
+    const std::string &input = Texts[state.range(2)];
+    std::string out;
+    const size_t allocations = allocation_count();
+    for (auto _ : state) {
+        out.clear();
+        latin_to_baybayin(input, out, ortho, style);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_allocations(state, allocations);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+BENCHMARK(BM_Runtime)->ArgNames({"ortho", "virama", "input"})->ArgsProduct({{0, 1, 2}, {0, 1}, {0, 1, 2}});
+
+// A new string for every call, as the convenience overload returns
+static void
+BM_Returned(benchmark::State &state) {
+    const std::string &input = Texts[state.range(0)];
+    const size_t allocations = allocation_count();
+    for (auto _ : state) {
+        auto out = latin_to_baybayin(input);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_allocations(state, allocations);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+BENCHMARK(BM_Returned)->Apply(input_arg);
+
+// Orthography and Virama are template arguments
+template<Orthography TOrtho, Virama TStyle>
+static void
+BM_Templated(benchmark::State &state) {
+    std::string out;
+    const size_t allocations = allocation_count();
+    for (auto _ : state) {
+        out.clear();
+        latin_to_baybayin<TOrtho, TStyle>(Document, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_allocations(state, allocations);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * Document.size()));
+}
+
+BENCHMARK_TEMPLATE(BM_Templated, Orthography::Traditional, Virama::Krus);
+BENCHMARK_TEMPLATE(BM_Templated, Orthography::Traditional, Virama::Pamudpod);
+BENCHMARK_TEMPLATE(BM_Templated, Orthography::Reformed, Virama::Krus);
+BENCHMARK_TEMPLATE(BM_Templated, Orthography::Reformed, Virama::Pamudpod);
+BENCHMARK_TEMPLATE(BM_Templated, Orthography::Modern, Virama::Krus);
+BENCHMARK_TEMPLATE(BM_Templated, Orthography::Modern, Virama::Pamudpod);
+
+static std::vector<std::string_view>
+make_words(const std::string_view document) {
+    std::vector<std::string_view> words;
+    for (size_t start = 0, end; start < document.size(); start = end + 1) {
+        end = std::min(document.find_first_of(" \n", start), document.size());
+        if (end > start) {
+            words.push_back(document.substr(start, end - start));
+        }
+    }
+    return words;
+}
+
+static const std::vector<std::string_view> DocumentWords = make_words(Document);
+
+// One result string per word
+static void
+BM_Words(benchmark::State &state) {
+    const size_t allocations = allocation_count();
+    for (auto _ : state) {
+        for (const auto word : DocumentWords) {
+            auto out = latin_to_baybayin(word);
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+    set_allocations(state, allocations);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * DocumentWords.size()));
+}
+
+BENCHMARK(BM_Words);
+
+// Every word into one arena
+static void
+BM_Batch(benchmark::State &state) {
+    const size_t allocations = allocation_count();
+    for (auto _ : state) {
+        auto batch = latin_to_baybayin_batch(DocumentWords);
+        benchmark::DoNotOptimize(batch.data.data());
+    }
+    set_allocations(state, allocations);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * DocumentWords.size()));
+}
+
+BENCHMARK(BM_Batch);
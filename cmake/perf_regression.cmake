@@ -0,0 +1,82 @@
+# Throughput regression check, run by the perf_regression test:
+#
+#   cmake -DCORPUS=<baybayin-corpus> -DTL=<tl> -DNORM=<norm> -DBASELINE=<perf_baseline.json> -DWORK_DIR=<dir>
+#         [-DUPDATE_BASELINE=ON] -P perf_regression.cmake
+#
+# Generates the corpus the baseline names once into WORK_DIR, runs every tool invocation in the baseline over it,
+# best of repeat, and fails if any is slower than its recorded MB/s by more than tolerance_percent. UPDATE_BASELINE
+# records the measured figures instead, for a new machine or an intended change.
+cmake_minimum_required(VERSION 3.23) # string(TIMESTAMP) with %f
+
+foreach(var CORPUS TL NORM BASELINE WORK_DIR)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "perf_regression: ${var} is not set")
+    endif()
+endforeach()
+
+file(READ "${BASELINE}" baseline)
+string(JSON size GET "${baseline}" size)
+string(JSON seed GET "${baseline}" seed)
+string(JSON repeat GET "${baseline}" repeat)
+string(JSON tolerance GET "${baseline}" tolerance_percent)
+
+set(corpus "${WORK_DIR}/perf_corpus_${seed}_${size}.txt")
+if(NOT EXISTS "${corpus}")
+    message(STATUS "generating ${size} bytes of corpus, seed ${seed}")
+    execute_process(COMMAND "${CORPUS}" --size ${size} --seed ${seed} --output "${corpus}.tmp"
+                    RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "perf_regression: baybayin-corpus failed: ${result}")
+    endif()
+    file(RENAME "${corpus}.tmp" "${corpus}")
+endif()
+file(SIZE "${corpus}" bytes)
+
+set(failures "")
+string(JSON count LENGTH "${baseline}" runs)
+math(EXPR last "${count} - 1")
+foreach(index RANGE ${last})
+    string(JSON name MEMBER "${baseline}" runs ${index})
+    string(JSON tool GET "${baseline}" runs ${name} tool)
+    string(TOUPPER "${tool}" tool)
+    set(args "")
+    string(JSON arg_count LENGTH "${baseline}" runs ${name} args)
+    if(arg_count GREATER 0)
+        math(EXPR arg_last "${arg_count} - 1")
+        foreach(arg_index RANGE ${arg_last})
+            string(JSON arg GET "${baseline}" runs ${name} args ${arg_index})
+            list(APPEND args "${arg}")
+        endforeach()
+    endif()
+
+    # best of repeat, in decimal MB/s, which is bytes per microsecond
+    set(best 0)
+    foreach(run RANGE 1 ${repeat})
+        string(TIMESTAMP start "%s%f")
+        execute_process(COMMAND "${${tool}}" ${args} --input "${corpus}" --output /dev/null RESULT_VARIABLE result)
+        string(TIMESTAMP end "%s%f")
+        if(NOT result EQUAL 0)
+            message(FATAL_ERROR "perf_regression: ${name} failed: ${result}")
+        endif()
+        math(EXPR throughput "${bytes} / (${end} - ${start})")
+        if(throughput GREATER best)
+            set(best ${throughput})
+        endif()
+    endforeach()
+
+    string(JSON expected GET "${baseline}" runs ${name} mb_per_s)
+    math(EXPR floor "${expected} * (100 - ${tolerance}) / 100")
+    message(STATUS "${name}: ${best} MB/s, baseline ${expected} MB/s")
+    if(UPDATE_BASELINE)
+        string(JSON baseline SET "${baseline}" runs ${name} mb_per_s ${best})
+    elseif(best LESS floor)
+        list(APPEND failures "${name}")
+    endif()
+endforeach()
+
+if(UPDATE_BASELINE)
+    file(WRITE "${BASELINE}" "${baseline}\n")
+    message(STATUS "updated ${BASELINE}")
+elseif(failures)
+    message(FATAL_ERROR "perf_regression: slower than the baseline by more than ${tolerance}%: ${failures}")
+endif()
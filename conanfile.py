@@ -11,6 +11,7 @@ class MyProject(ConanFile):
     def requirements(self):
         self.requires("cli11/[>=2.6.0]")
         self.requires("gtest/[>=1.14.0]")
+        self.requires("benchmark/[>=1.8.0]")
 
     def layout(self):
         # Automatically manages build/Release and build/Debug folders
@@ -0,0 +1,141 @@
+#ifndef BAYBAYIN_CAPI_H
+#define BAYBAYIN_CAPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * The C API of libbaybayin, for calling the engines in process from other languages. Its ABI is stable within
+ * BAYBAYIN_ABI_VERSION: functions are only ever added, and baybayin_config carries its own size so fields can be
+ * appended to it.
+ *
+ * An engine is configured once and then used by one thread at a time. It keeps its scratch buffers between calls,
+ * so once they have grown to the longest input a call allocates nothing. Output goes to buffers the caller owns;
+ * the *_bound functions give a capacity that always suffices. No C++ exception crosses the boundary: every failure
+ * is a baybayin_status.
+ */
+
+#if defined(__GNUC__)
+#define BAYBAYIN_API __attribute__((visibility("default")))
+#else
+#define BAYBAYIN_API
+#endif
+
+#define BAYBAYIN_ABI_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum baybayin_status {
+    BAYBAYIN_OK = 0,
+    BAYBAYIN_INVALID_ARGUMENT = 1, /* a null pointer or a setting out of range */
+    BAYBAYIN_BUFFER_TOO_SMALL = 2,
+    BAYBAYIN_OUT_OF_MEMORY = 3,
+} baybayin_status;
+
+/* Settings, with the values and meaning of the norm and tl options */
+enum {
+    BAYBAYIN_SPANISH = 0,
+    BAYBAYIN_ENGLISH = 1,
+};
+
+enum {
+    BAYBAYIN_ABAKADA = 0,
+    BAYBAYIN_ALPABETONG = 1,
+};
+
+/* diphthongs, clusters and the Baybayin orthography */
+enum {
+    BAYBAYIN_TRADITIONAL = 0,
+    BAYBAYIN_REFORMED = 1,
+    BAYBAYIN_MODERN = 2, /* the Baybayin orthography only */
+};
+
+enum {
+    BAYBAYIN_KRUS = 0,
+    BAYBAYIN_PAMUDPOD = 1,
+};
+
+typedef struct baybayin_config {
+    uint32_t size; /* sizeof(baybayin_config), set by baybayin_config_init */
+    int32_t language;
+    int32_t latin_orthography;
+    int32_t diphthongs;
+    int32_t clusters;
+    int32_t orthography;
+    int32_t virama;
+} baybayin_config;
+
+typedef struct baybayin_engine baybayin_engine;
+
+/* BAYBAYIN_ABI_VERSION of the library loaded */
+BAYBAYIN_API uint32_t
+baybayin_abi_version(void);
+
+/* Sets config to the defaults: Spanish, abakada, reformed diphthongs, clusters and orthography, krus */
+BAYBAYIN_API void
+baybayin_config_init(baybayin_config *config);
+
+/* Creates an engine for config, to be released with baybayin_engine_destroy */
+BAYBAYIN_API baybayin_status
+baybayin_engine_create(const baybayin_config *config, baybayin_engine **engine);
+
+BAYBAYIN_API void
+baybayin_engine_destroy(baybayin_engine *engine);
+
+/*
+ * Single calls: the result for input[0, input_size) is written to output and its size to *output_size. If it does
+ * not fit in output_capacity bytes the call returns BAYBAYIN_BUFFER_TOO_SMALL with the size it needs in
+ * *output_size, and the contents of output are unspecified.
+ */
+
+/* Normalizes raw Latin text, as norm does */
+BAYBAYIN_API baybayin_status
+baybayin_normalize(baybayin_engine *engine, const char *input, size_t input_size, char *output,
+                   size_t output_capacity, size_t *output_size);
+
+/* Transliterates normalized Latin text, as tl does */
+BAYBAYIN_API baybayin_status
+baybayin_transliterate(baybayin_engine *engine, const char *input, size_t input_size, char *output,
+                       size_t output_capacity, size_t *output_size);
+
+/* Normalizes and transliterates raw Latin text in one pass, as tl --normalize does */
+BAYBAYIN_API baybayin_status
+baybayin_normalize_transliterate(baybayin_engine *engine, const char *input, size_t input_size, char *output,
+                                 size_t output_capacity, size_t *output_size);
+
+/* The most output the calls above can produce for input_size bytes */
+BAYBAYIN_API size_t
+baybayin_normalize_bound(const baybayin_engine *engine, size_t input_size);
+
+BAYBAYIN_API size_t
+baybayin_transliterate_bound(const baybayin_engine *engine, size_t input_size);
+
+BAYBAYIN_API size_t
+baybayin_normalize_transliterate_bound(const baybayin_engine *engine, size_t input_size);
+
+/*
+ * Batch calls, over count texts packed into one buffer Arrow style: text i is input[input_offsets[i],
+ * input_offsets[i + 1]) and its result is written to output[output_offsets[i], output_offsets[i + 1]), so both
+ * offset arrays hold count + 1 entries. A capacity of the bound of input_offsets[count] bytes always suffices. On
+ * BAYBAYIN_BUFFER_TOO_SMALL the results that fit are written, and output_offsets set up to the first that did not.
+ */
+
+BAYBAYIN_API baybayin_status
+baybayin_normalize_batch(baybayin_engine *engine, const char *input, const size_t *input_offsets, size_t count,
+                         char *output, size_t output_capacity, size_t *output_offsets);
+
+BAYBAYIN_API baybayin_status
+baybayin_transliterate_batch(baybayin_engine *engine, const char *input, const size_t *input_offsets, size_t count,
+                             char *output, size_t output_capacity, size_t *output_offsets);
+
+BAYBAYIN_API baybayin_status
+baybayin_normalize_transliterate_batch(baybayin_engine *engine, const char *input, const size_t *input_offsets,
+                                       size_t count, char *output, size_t output_capacity, size_t *output_offsets);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,23 +1,319 @@
 #pragma once
 
 #include <baybayin-core/norm/consonants.h>
+#include <baybayin-core/norm/fast.h>
+#include <baybayin-core/norm/languages.h>
+#include <baybayin-core/norm/lexicon.h>
 #include <baybayin-core/norm/vowels.h>
+#include <baybayin-core/util/batch.h>
+#include <baybayin-core/util/cache.h>
+#include <baybayin-core/util/utf8.h>
 #include <baybayin-core/util/util.h>
+#include <baybayin-core/util/writer.h>
+#include <memory_resource>
+#include <span>
 #include <string>
 #include <string_view>
 
 namespace phil_norm {
 
+/**
+ * @name normalizer
+ * @brief Normalizes input, appending to output. Its UTF-8 is folded first, see baybayin::fold_latin, as in every
+ * entry point below; the passes themselves see bytes. The text between the passes is allocated as output is, so
+ * for a std::pmr::string both come from its resource.
+ */
+template<baybayin::CharString TString>
+void
+normalizer(const std::string_view &input, TString &output, const ForeignLanguage language,
+           const LatinOrthography orthography, const Diphthong diphthongs, const InitialCluster clusters
+) {
+    TString folded(output.get_allocator());
+    TString firstPass(output.get_allocator());
+    consonant_normalize_dispatch(baybayin::fold_latin(input, folded), firstPass, language, orthography);
+    vowel_normalize_dispatch(firstPass, output, language, orthography, diphthongs, clusters);
+}
+
 inline std::string
 normalizer(const std::string_view &input, const ForeignLanguage language, const LatinOrthography orthography,
            const Diphthong diphthongs, const InitialCluster clusters
 ) {
-    std::string firstPass, secondPass;
-    consonant_normalize_dispatch(input, firstPass, language, orthography);
-    vowel_normalize_dispatch(firstPass, secondPass, language, orthography, diphthongs);
-    if (clusters == InitialCluster::TRADITIONAL) {
-        // TODO: smooth consonant cluster first-syllables with an extra vowel
+    std::string output;
+    normalizer(input, output, language, orthography, diphthongs, clusters);
+    return output;
+}
+
+/**
+ * @name normalizer
+ * @brief Normalizes input into a string allocated from resource, as are the buffers in between.
+ */
+inline std::pmr::string
+normalizer(const std::string_view &input, std::pmr::memory_resource *resource, const ForeignLanguage language,
+           const LatinOrthography orthography, const Diphthong diphthongs, const InitialCluster clusters
+) {
+    std::pmr::string output(resource);
+    normalizer(input, output, language, orthography, diphthongs, clusters);
+    return output;
+}
+
+/**
+ * @name fast_normalizer
+ * @brief Normalizes input as normalizer does, in a single pass, appending to output. Reusing output across calls
+ * avoids allocating once it has grown. The scratch between the passes is allocated as output is.
+ */
+template<baybayin::CharString TString>
+void
+fast_normalizer(const std::string_view &input, TString &output, const ForeignLanguage language,
+                const LatinOrthography orthography, const Diphthong diphthongs, const InitialCluster clusters
+) {
+    TString folded(output.get_allocator());
+    TString stage(output.get_allocator());
+    fast_normalize_dispatch(baybayin::fold_latin(input, folded), output, stage, language, orthography, diphthongs,
+                            clusters);
+}
+
+/**
+ * @name fast_normalizer
+ * @brief Normalizes input as normalizer does, in a single pass.
+ */
+inline std::string
+fast_normalizer(const std::string_view &input, const ForeignLanguage language, const LatinOrthography orthography,
+                const Diphthong diphthongs, const InitialCluster clusters
+) {
+    std::string output;
+    fast_normalizer(input, output, language, orthography, diphthongs, clusters);
+    return output;
+}
+
+/**
+ * @name fast_normalizer
+ * @brief Normalizes input as normalizer does, in a single pass, into a string allocated from resource.
+ */
+inline std::pmr::string
+fast_normalizer(const std::string_view &input, std::pmr::memory_resource *resource, const ForeignLanguage language,
+                const LatinOrthography orthography, const Diphthong diphthongs, const InitialCluster clusters
+) {
+    std::pmr::string output(resource);
+    fast_normalizer(input, output, language, orthography, diphthongs, clusters);
+    return output;
+}
+
+/**
+ * @name consonants_emit
+ * @brief Whether the consonant pass of rules writes anything for input, already folded, which decides if the
+ * whitespace before it is kept. The pass runs in scratch, a buffer of the caller's it is free to overwrite.
+ */
+inline bool
+consonants_emit(const std::string_view &input, const RuleSet &rules, std::string &scratch) {
+    scratch.clear();
+    consonant_normalize(input, scratch, rules);
+    return !scratch.empty();
+}
+
+/**
+ * @name normalize_words
+ * @brief Runs a word at a time engine over input, looking each whitespace separated word up in cache first, and
+ * lays out the whitespace between words as the consonant pass does: a run of it becomes one space, leading
+ * whitespace is dropped, trailing whitespace keeps all but one space, and the spaces before a word the consonant
+ * pass writes nothing for stay pending. Neither pass looks past the whitespace byte after a word, so a word
+ * normalizes the same with just that byte after it as in its text. The last word sees the end of the text
+ * instead and is cached apart.
+ * @param miss The caller's buffer a word missing from cache is normalized into before it is stored
+ * @param tag The engine and its configuration, see WordCacheTag
+ * @param word Appends the output for one word, given with the whitespace byte after it unless it is the last:
+ * bool(std::string_view text, std::string &output), returning whether the consonant pass wrote anything for it
+ * @param space The output for one space
+ */
+template<typename TWord>
+void
+normalize_words(const std::string_view &input, std::string &output, baybayin::WordCache &cache, std::string &miss,
+                const uint32_t tag, TWord &&word, const std::string_view space
+) {
+    bool emitted = false;
+    size_t pending = 0;
+    baybayin::StringWriter writer(output);
+    for (const auto &[text, size] : baybayin::Words(input, baybayin::ByteSpace)) {
+        if (size > 0) {
+            const auto key = text.substr(0, size);
+            // only the last word has no whitespace after it
+            const uint32_t word_tag = tag | (size == text.size() ? static_cast<uint32_t>(baybayin::CacheLastWord) : 0u);
+            const size_t mark = writer.size();
+            writer.reserve(pending * space.size());
+            for (size_t s = 0; s < pending; s++) {
+                writer.append(space);
+            }
+            bool emits;
+            const bool fits = size <= baybayin::WordCache::SlotBytes;
+            const uint64_t hash = fits ? baybayin::WordCache::hash(word_tag, key) : 0;
+            if (const auto *entry = fits ? cache.find(hash, word_tag, key) : nullptr) {
+                emits = entry->flags != 0;
+                writer.reserve(baybayin::WordCache::SlotBytes);
+                writer.template append_block<baybayin::WordCache::SlotBytes>(entry->bytes.data(), entry->value_size);
+            } else {
+                miss.clear();
+                emits = word(text.substr(0, size + 1), miss);
+                if (fits) {
+                    cache.insert(hash, word_tag, key, miss, emits);
+                }
+                writer.reserve(miss.size());
+                writer.append(miss);
+            }
+            if (emits) {
+                emitted = true;
+                pending = 0;
+            } else {
+                writer.resize(mark);
+            }
+        }
+        if (size < text.size()) {
+            pending += emitted ? 1 : 0;
+        }
+    }
+    writer.reserve(pending * space.size());
+    for (size_t s = 1; s < pending; s++) {
+        writer.append(space);
+    }
+    writer.finish();
+}
+
+/**
+ * @name Normalizer
+ * @brief A normalizer configured once. It keeps its own copy of the rules, and the output and scratch buffers are
+ * kept between calls, so once they have grown to the longest input a call allocates nothing. A built-in
+ * configuration is looked up in DispatchTable once, on construction.
+ */
+class Normalizer {
+    FastNormalizeFunction builtin_ = nullptr; // the built-in configuration, none for rules of its own
+    Language language_;
+    Lexicon lexicon_;
+    InitialCluster clusters_;
+    uint32_t tag_;
+    bool cacheable_ = true;
+    std::string output_;
+    std::string stage_;
+    std::string folded_;
+    std::string miss_;
+
+    void
+    normalize_folded(const std::string_view &input, std::string &output) {
+        if (builtin_ != nullptr) {
+            builtin_(input, output, stage_, lexicon_);
+        } else if (clusters_ == InitialCluster::TRADITIONAL) {
+            fast_normalize<InitialCluster::TRADITIONAL>(input, output, stage_, language_, lexicon_);
+        } else {
+            fast_normalize<InitialCluster::REFORMED>(input, output, stage_, language_, lexicon_);
+        }
+    }
+
+public:
+    /**
+     * @param lexicon Words to normalize as it has them rather than by the rules, see fast_normalize. The image it
+     * views has to outlive the normalizer.
+     */
+    Normalizer(const ForeignLanguage language, const LatinOrthography orthography, const Diphthong diphthongs,
+               const InitialCluster clusters, const Lexicon &lexicon = {}
+    ) : builtin_(DispatchTable<FastNormalizeEntry>[configuration_index(language, orthography, clusters)]),
+        language_(builtin_language(language, orthography)), lexicon_(lexicon), clusters_(clusters),
+        tag_(baybayin::CacheNormalize | configuration_tag(language, orthography, diphthongs, clusters) |
+             (lexicon.empty() ? 0u : static_cast<uint32_t>(baybayin::CacheLexicon))) {
+    }
+
+    /**
+     * @brief A normalizer with rules of its own, loaded by parse_language. Its rules may look across the whitespace
+     * between words, so it never normalizes a word at a time and a cache passed to it goes unused.
+     */
+    Normalizer(const Language &language, const InitialCluster clusters, const Lexicon &lexicon = {}) :
+        language_(language), lexicon_(lexicon), clusters_(clusters), tag_(baybayin::CacheNormalize),
+        cacheable_(false) {
+    }
+
+    /**
+     * @name normalize
+     * @brief Normalizes input as normalizer does.
+     * @return The normalized text, valid until the next call
+     */
+    std::string_view
+    normalize(const std::string_view &input) {
+        output_.clear();
+        normalize(input, output_);
+        return output_;
+    }
+
+    /**
+     * @name normalize
+     * @brief Normalizes input as normalizer does, appending to output.
+     */
+    void
+    normalize(const std::string_view &input, std::string &output) {
+        normalize_folded(baybayin::fold_latin(input, folded_), output);
+    }
+
+    /**
+     * @name normalize
+     * @brief Normalizes input as normalizer does, appending to output, a word at a time through cache. Words are
+     * keyed as folded, their whitespace and punctuation as much as their letters.
+     */
+    void
+    normalize(const std::string_view &input, std::string &output, baybayin::WordCache &cache) {
+        if (!cacheable_ || cache.bypass(input.size())) {
+            normalize(input, output);
+            return;
+        }
+        const auto folded = baybayin::fold_latin(input, folded_);
+        normalize_words(folded, output, cache, miss_, tag_, [this](const std::string_view &text, std::string &out) {
+            const size_t mark = out.size();
+            normalize_folded(text, out);
+            return out.size() > mark || consonants_emit(text, language_.consonants, stage_);
+        }, " ");
+    }
+};
+
+/**
+ * @name normalize_growth
+ * @brief The most bytes the built-in normalization for these settings writes for a byte of input. Folding never
+ * lengthens the input, so this bounds the whole normalizer.
+ */
+inline size_t
+normalize_growth(const ForeignLanguage language, const LatinOrthography orthography,
+                 const InitialCluster clusters) noexcept {
+    const auto &rules = builtin_language(language, orthography);
+    return rules.consonants.growth() * (clusters == InitialCluster::TRADITIONAL
+                                            ? vowel_growth<InitialCluster::TRADITIONAL>(rules.vowels)
+                                            : vowel_growth<InitialCluster::REFORMED>(rules.vowels));
+}
+
+/**
+ * @name normalizer_batch
+ * @brief Normalizes every input into batch, replacing its contents. The arena is sized by normalize_growth once for
+ * the whole column, and the single pass engine and folding work in the batch's scratch buffers, so a fresh Batch
+ * costs an allocation for each and a reused one none.
+ */
+inline void
+normalizer_batch(const std::span<const std::string_view> inputs, baybayin::Batch &batch,
+                 const ForeignLanguage language, const LatinOrthography orthography, const Diphthong diphthongs,
+                 const InitialCluster clusters
+) {
+    batch.clear();
+    batch.offsets.reserve(inputs.size() + 1);
+    batch.data.reserve(baybayin::total_size(inputs) * normalize_growth(language, orthography, clusters));
+    batch.offsets.push_back(0);
+    for (const auto &input : inputs) {
+        fast_normalize_dispatch(baybayin::fold_latin(input, batch.folded), batch.data, batch.stage, language,
+                                orthography, diphthongs, clusters);
+        batch.offsets.push_back(batch.data.size());
     }
-    return std::move(secondPass);
+}
+
+/**
+ * @name normalizer_batch
+ * @brief Normalizes a column of short strings into one arena.
+ */
+inline baybayin::Batch
+normalizer_batch(const std::span<const std::string_view> inputs, const ForeignLanguage language,
+                 const LatinOrthography orthography, const Diphthong diphthongs, const InitialCluster clusters
+) {
+    baybayin::Batch batch;
+    normalizer_batch(inputs, batch, language, orthography, diphthongs, clusters);
+    return batch;
 }
 }
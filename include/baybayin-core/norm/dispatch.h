@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <baybayin-core/norm/languages.h>
+#include <baybayin-core/util/util.h>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Runtime parameters onto the built-in configurations. Each combination of ForeignLanguage, LatinOrthography and
+// InitialCluster gets its own instantiation of an engine, with its rules as compile-time constants, and a table of
+// pointers to those generated at compile time, so a call with runtime parameters is one load and one indirect call
+// however many languages are registered with BuiltinRules.
+
+namespace phil_norm {
+
+inline constexpr size_t ConfigurationCount = ForeignLanguageCount * LatinOrthographyCount * InitialClusterCount;
+
+/**
+ * @name configuration_index
+ * @brief The index of a configuration in the dispatch tables.
+ */
+constexpr size_t
+configuration_index(const ForeignLanguage language, const LatinOrthography orthography,
+                    const InitialCluster clusters) noexcept {
+    return (static_cast<size_t>(language) * LatinOrthographyCount + static_cast<size_t>(orthography)) *
+           InitialClusterCount + static_cast<size_t>(clusters);
+}
+
+/**
+ * @name configuration_tag
+ * @brief The configuration of a normalizer for a WordCache tag, in the low 16 bits.
+ */
+constexpr uint32_t
+configuration_tag(const ForeignLanguage language, const LatinOrthography orthography, const Diphthong diphthongs,
+                  const InitialCluster clusters) noexcept {
+    return static_cast<uint32_t>(configuration_index(language, orthography, clusters)) << 1 |
+           static_cast<uint32_t>(diphthongs);
+}
+
+template<template<ForeignLanguage, LatinOrthography, InitialCluster, typename...> typename TEntry,
+         typename... TArgs, size_t... Index>
+consteval auto
+make_dispatch_table(std::index_sequence<Index...>) {
+    constexpr size_t per_language = LatinOrthographyCount * InitialClusterCount;
+    return std::array{&TEntry<static_cast<ForeignLanguage>(Index / per_language),
+                              static_cast<LatinOrthography>(Index / InitialClusterCount % LatinOrthographyCount),
+                              static_cast<InitialCluster>(Index % InitialClusterCount), TArgs...>::run...};
+}
+
+/**
+ * @name DispatchTable
+ * @brief TEntry<language, orthography, clusters, TArgs...>::run for every configuration, indexed by
+ * configuration_index. The run functions of all entries have to share one signature. TArgs are passed through,
+ * the string type an entry writes to for one.
+ */
+template<template<ForeignLanguage, LatinOrthography, InitialCluster, typename...> typename TEntry,
+         typename... TArgs>
+inline constexpr auto DispatchTable =
+    make_dispatch_table<TEntry, TArgs...>(std::make_index_sequence<ConfigurationCount>());
+
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <baybayin-core/norm/consonants.h>
+#include <baybayin-core/norm/dispatch.h>
+#include <baybayin-core/norm/languages.h>
+#include <baybayin-core/norm/lexicon.h>
+#include <baybayin-core/norm/rules.h>
+#include <baybayin-core/norm/vowels.h>
+#include <baybayin-core/util/scan.h>
+#include <baybayin-core/util/stats.h>
+#include <baybayin-core/util/util.h>
+#include <baybayin-core/util/writer.h>
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// The consonant and vowel passes fused into one loop over the input. Both passes leave most bytes alone, so the
+// engine copies runs of those in bulk and only walks the rule trie for bytes a rule starts with, writing through a
+// StringWriter with room reserved a block at a time. Its output is the same as consonant_normalize followed by
+// vowel_normalize, which the tests check.
+
+using namespace phil_norm;
+
+/**
+ * @name consonant_rule_mask
+ * @brief The bytes of a scan block some consonant rule starts with, as a bit mask. Rules that need the start of a
+ * word, mga and ng, only count there: after whitespace or punctuation, not only where the pass is at the start of
+ * a word.
+ */
+[[gnu::always_inline]] inline uint32_t
+consonant_rule_mask(const std::string_view &input, const size_t base, const size_t width,
+                    const baybayin::ScanBlock &block, const RuleSet &rules
+) {
+    uint32_t any = 0;
+    uint32_t word = 0;
+    for (size_t k = 0; k < width; ++k) {
+        const uint8_t start = rules.start(block.lower[k]);
+        any |= uint32_t{(start & RuleStartAny) != 0} << k;
+        word |= uint32_t{(start & RuleStartWord) != 0} << k;
+    }
+    const uint32_t words = ~(block.masks.space | block.masks.punctuation);
+    const uint32_t starts = words & ~(words << 1 | (base > 0 && baybayin::is_word_byte(input[base - 1])));
+    return any | (word & starts);
+}
+
+/**
+ * @name fast_consonant_block
+ * @brief The consonant pass over one scan block, as consonant_normalize_block, copying everything no rule starts
+ * with straight through. The first byte of a word still takes the careful path for the held back spaces.
+ */
+template<typename TString>
+[[gnu::always_inline]] inline size_t
+fast_consonant_block(const std::string_view &input, size_t pos, ConsonantState &state, const RuleSet &rules,
+                     baybayin::StringWriter<TString> &output
+) {
+    const baybayin::StageTimer<baybayin::Stage::Consonants> timer;
+    baybayin::ScanBlock block;
+    const size_t base = pos;
+    const size_t width = std::min(baybayin::ScanWidth, input.size() - base);
+    baybayin::scan_block(input.data() + base, width, block);
+    // a match can run past the block by a pattern, and the held back spaces come on top
+    output.reserve(rules.growth() * (baybayin::ScanWidth + RuleSet::MaxPattern) + state.pending_spaces);
+    const uint32_t valid = width == baybayin::ScanWidth ? ~uint32_t{0} : (uint32_t{1} << width) - 1;
+    const uint32_t plain = ~(consonant_rule_mask(input, base, width, block, rules) | block.masks.space) & valid;
+    for (; pos < base + width; pos++) {
+        const size_t offset = pos - base;
+        if (block.masks.space >> offset & 1) {
+            if (state.emitted && !state.in_whitespace) {
+                state.pending_spaces++;
+                state.in_whitespace = true;
+            }
+            continue;
+        }
+        state.in_whitespace = false;
+        if (state.pending_spaces > 0 || !state.emitted) {
+            const size_t mark = output.size();
+            output.append(state.pending_spaces, ' ');
+            pos += rules.apply<baybayin::RulePass::Consonants>(input, pos, block.lower[offset], true, output);
+            if (output.size() > mark + state.pending_spaces) {
+                state.emitted = true;
+                state.pending_spaces = 0;
+            } else {
+                output.resize(mark);
+            }
+            continue;
+        }
+        if (const uint32_t run = plain >> offset;
+            run & 1) {
+            const size_t count = std::countr_one(run);
+            output.append(block.lower.data() + offset, count);
+            pos += count - 1;
+            continue;
+        }
+        pos += rules.apply<baybayin::RulePass::Consonants>(input, pos, block.lower[offset], false, output);
+    }
+    return pos;
+}
+
+// Consonant pass output staged before the vowel pass runs over it, so the vowel pass sets up once for several blocks
+inline constexpr size_t VowelBatch = 8 * baybayin::ScanWidth;
+
+/**
+ * @name vowel_normalize_staged
+ * @brief Runs the vowel pass over the consonant pass output staged so far, once there is a VowelBatch of it, from
+ * done up to where its rules can see far enough ahead, and drops the front of staged the rules no longer look back
+ * on.
+ * @param done Where the vowel pass is in staged, updated
+ */
+template<InitialCluster Clusters = InitialCluster::REFORMED, typename TString, typename TOut>
+[[gnu::always_inline]] inline void
+vowel_normalize_staged(baybayin::StringWriter<TString> &staged, size_t &done, const RuleSet &rules, TOut &output) {
+    const size_t reach = vowel_reach<Clusters>(rules);
+    if (const auto text = staged.view();
+        text.size() >= done + reach + VowelBatch) {
+        output.reserve(vowel_growth<Clusters>(rules) * (text.size() - done));
+        done = vowel_normalize_range<Clusters>(text, done, text.size() - reach, rules, output);
+        const size_t drop = done - std::min(done, vowel_behind<Clusters>(rules));
+        staged.erase_front(drop);
+        done -= drop;
+    }
+}
+
+/**
+ * @name fast_normalize
+ * @brief Both passes in one loop: the consonant pass output is run through the vowel pass a batch at a time, once
+ * it has the lookahead the vowel rules need, so the text between them never exceeds a few blocks. Words found in
+ * lexicon are written as it has them instead, the passes running up to each and resuming after it; the rules
+ * around one still read its letters as written.
+ * @tparam Clusters As for vowel_normalize_range
+ * @param output Appended to
+ * @param stage Scratch buffer between the passes
+ */
+template<InitialCluster Clusters = InitialCluster::REFORMED, baybayin::CharString TString>
+void
+fast_normalize(const std::string_view &input, TString &output, TString &stage, const Language &language,
+               const Lexicon &lexicon = {}) {
+    baybayin::StringWriter out(output);
+    out.reserve(input.size() + input.size() / 8);
+    stage.clear();
+    baybayin::StringWriter staged(stage);
+    ConsonantState state;
+    size_t done = 0;
+    size_t pos = 0;
+    const size_t growth = vowel_growth<Clusters>(language.vowels);
+    // both passes over the input up to the end of text, which starts as input does
+    const auto normalize = [&](const std::string_view text) {
+        while (pos < text.size()) {
+            pos = fast_consonant_block(text, pos, state, language.consonants, staged);
+            vowel_normalize_staged<Clusters>(staged, done, language.vowels, out);
+        }
+    };
+    std::string_view value;
+    baybayin::for_each_word(lexicon.empty() ? std::string_view() : input, [&](const size_t start, const size_t size) {
+        if (!lexicon.find(input.substr(start, size), value)) {
+            return;
+        }
+        normalize(input.substr(0, start));
+        // the word ends what the vowel pass can see, so it runs to the end
+        const auto text = staged.view();
+        out.reserve(growth * (text.size() - done) + state.pending_spaces + value.size());
+        vowel_normalize_range<Clusters>(text, done, text.size(), language.vowels, out);
+        staged.erase_front(text.size());
+        done = 0;
+        out.append(state.pending_spaces, ' ');
+        out.append(value);
+        state.emitted = true;
+        state.pending_spaces = 0;
+        state.in_whitespace = false;
+        pos = start + size;
+    });
+    normalize(input);
+    staged.reserve(state.pending_spaces);
+    consonant_normalize_finish(state, staged);
+    const auto text = staged.view();
+    out.reserve(growth * (text.size() - done));
+    vowel_normalize_range<Clusters>(text, done, text.size(), language.vowels, out);
+    out.finish();
+}
+
+using FastNormalizeFunction = void (*)(const std::string_view &, std::string &, std::string &, const Lexicon &);
+
+template<ForeignLanguage LanguageId, LatinOrthography OrthographyId, InitialCluster Clusters,
+         typename TString = std::string>
+struct FastNormalizeEntry {
+    static void
+    run(const std::string_view &input, TString &output, TString &stage, const Lexicon &lexicon) {
+        fast_normalize<Clusters>(input, output, stage, BuiltinLanguage<LanguageId, OrthographyId>, lexicon);
+    }
+};
+
+/**
+ * @name fast_normalize_dispatch
+ * @brief Runs fast_normalize with the built-in rules for the runtime parameters provided, through DispatchTable.
+ * No built-in rule depends on dipht yet.
+ */
+template<baybayin::CharString TString>
+void
+fast_normalize_dispatch(const std::string_view &input, TString &output, TString &stage,
+                        const ForeignLanguage lang, const LatinOrthography ortho,
+                        [[maybe_unused]] const Diphthong dipht, const InitialCluster clusters
+) {
+    DispatchTable<FastNormalizeEntry, TString>[configuration_index(lang, ortho, clusters)](input, output, stage, {});
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <array>
+#include <baybayin-core/norm/rules.h>
+#include <baybayin-core/util/chars.h>
+#include <baybayin-core/util/util.h>
+#include <string>
+#include <span>
+#include <string_view>
+#include <utility>
+
+// The built-in normalization rules, one table per pass for each foreign language and Latin orthography, and the
+// rule file format the same tables can be loaded from.
+
+namespace phil_norm {
+
+/**
+ * @name Language
+ * @brief The rules of both passes for one source language and target orthography. The consonant pass sees the
+ * input, the vowel pass the output of the consonant pass.
+ */
+struct Language {
+    RuleSet consonants;
+    RuleSet vowels;
+};
+
+// ñ, and mga and ng spelled out, in every language
+inline constexpr std::array CommonConsonantRules = std::to_array<Rule>({
+    {"", "\xC3\xB1", "", "ny"},
+    {"", "\xC3\x91", "", "ny"},
+    {"", "\xC3", "", ""}, // a lone lead byte
+    {"^", "mga", "$", "manga"},
+    {"^", "ng", "$", "nang"},
+});
+
+inline constexpr std::array SpanishAbakadaConsonantRules = std::to_array<Rule>({
+    {"", "f", "", "p"},
+    {"", "v", "", "b"},
+    {"", "z", "", "s"},
+    {"^", "x", "", "s"},
+    {"", "x", "C", "s"},
+    {"", "x", "", "ks"},
+    {"", "ch", "N", "k"},
+    {"", "ch", "", "ts"},
+    {"", "c", "a", "k"},
+    {"", "c", "o", "k"},
+    {"", "c", "u", "k"},
+    {"", "c", "", "s"},
+    {"", "j", "", "h"},
+    {"", "qu", "", "k"},
+    {"", "q", "", "k"},
+    {"", "ll", "", "y"},
+});
+
+inline constexpr std::array EnglishAbakadaConsonantRules = std::to_array<Rule>({
+    {"", "f", "", "p"},
+    {"", "v", "", "b"},
+    {"", "z", "", "s"},
+    {"^", "x", "", "s"},
+    {"", "x", "C", "s"},
+    {"", "x", "", "ks"},
+    {"", "ch", "N", "k"},
+    {"", "ch", "", "ts"},
+    {"", "ck", "", "k"},
+    {"", "c", "e", "s"},
+    {"", "c", "i", "s"},
+    {"", "c", "", "k"},
+    {"", "j", "", "dy"},
+    {"", "qu", "", "kw"},
+    {"", "q", "", "k"},
+    {"", "ph", "", "p"},
+});
+
+inline constexpr std::array EnglishAlpabetongConsonantRules = std::to_array<Rule>({
+    {"", "ph", "", "f"},
+});
+
+inline constexpr std::array EnglishAbakadaVowelRules = std::to_array<Rule>({
+    {"", "ai", "", "ey"},
+    {"", "ay", "", "ey"},
+    {"", "au", "", "o"},
+    {"", "aw", "", "o"},
+    {"", "ae", "", "o"},
+    {"", "a", "Ce", "ey"},
+    {"", "oa", "", "o"},
+    {"", "ee", "", "i"},
+    {"", "e", "$", ""}, // silent e
+});
+
+consteval RuleSet
+make_rules(const std::span<const Rule> rules) {
+    RuleSet set(CommonConsonantRules);
+    for (const auto &rule : rules) {
+        if (!set.add(rule)) {
+            throw "invalid built-in rule";
+        }
+    }
+    return set;
+}
+
+/**
+ * @name BuiltinRules
+ * @brief The rule tables of one built-in language and orthography, the consonant rules going on top of
+ * CommonConsonantRules. A source language is registered by giving ForeignLanguage a value for it, counting it in
+ * ForeignLanguageCount and specializing BuiltinRules for it in every orthography. The language and dispatch tables
+ * are generated from the specializations, so a missing one fails to compile.
+ */
+template<ForeignLanguage LanguageId, LatinOrthography OrthographyId>
+struct BuiltinRules;
+
+template<>
+struct BuiltinRules<ForeignLanguage::SPANISH, LatinOrthography::ABAKADA> {
+    static constexpr std::span<const Rule> consonants = SpanishAbakadaConsonantRules;
+    static constexpr std::span<const Rule> vowels{};
+};
+
+template<>
+struct BuiltinRules<ForeignLanguage::SPANISH, LatinOrthography::ALPABETONG> {
+    static constexpr std::span<const Rule> consonants{};
+    static constexpr std::span<const Rule> vowels{};
+};
+
+template<>
+struct BuiltinRules<ForeignLanguage::ENGLISH, LatinOrthography::ABAKADA> {
+    static constexpr std::span<const Rule> consonants = EnglishAbakadaConsonantRules;
+    static constexpr std::span<const Rule> vowels = EnglishAbakadaVowelRules;
+};
+
+template<>
+struct BuiltinRules<ForeignLanguage::ENGLISH, LatinOrthography::ALPABETONG> {
+    static constexpr std::span<const Rule> consonants = EnglishAlpabetongConsonantRules;
+    static constexpr std::span<const Rule> vowels{};
+};
+
+// The compiled rules of a built-in language and orthography
+template<ForeignLanguage LanguageId, LatinOrthography OrthographyId>
+inline constexpr Language BuiltinLanguage{make_rules(BuiltinRules<LanguageId, OrthographyId>::consonants),
+                                          RuleSet(BuiltinRules<LanguageId, OrthographyId>::vowels)};
+
+template<size_t... Index>
+consteval std::array<const Language *, sizeof...(Index)>
+make_builtin_languages(std::index_sequence<Index...>) {
+    return {&BuiltinLanguage<static_cast<ForeignLanguage>(Index / LatinOrthographyCount),
+                             static_cast<LatinOrthography>(Index % LatinOrthographyCount)>...};
+}
+
+// Indexed by ForeignLanguage, then LatinOrthography
+inline constexpr auto BuiltinLanguages =
+    make_builtin_languages(std::make_index_sequence<ForeignLanguageCount * LatinOrthographyCount>());
+
+constexpr const Language &
+builtin_language(const ForeignLanguage language, const LatinOrthography orthography) noexcept {
+    return *BuiltinLanguages[static_cast<size_t>(language) * LatinOrthographyCount +
+                             static_cast<size_t>(orthography)];
+}
+
+/**
+ * @name parse_language
+ * @brief Loads rules from text, one per line, after those already in language:
+ *
+ *     # pass      before  pattern  after  replacement
+ *     consonant   ^       x        -      s
+ *     vowel       -       e        $      -
+ *
+ * A - stands for an empty field, # starts a comment. Fields cannot hold whitespace.
+ * @return false with error set, naming the line, if a rule is malformed or does not fit
+ */
+inline bool
+parse_language(const std::string_view text, Language &language, std::string &error) {
+    size_t number = 0;
+    for (size_t start = 0; start < text.size();) {
+        const size_t end = std::min(text.find('\n', start), text.size());
+        auto line = text.substr(start, end - start);
+        start = end + 1;
+        ++number;
+        line = line.substr(0, line.find('#'));
+        std::array<std::string_view, 6> fields;
+        size_t count = 0;
+        for (const auto &word : baybayin::Words(line, baybayin::ByteSpace)) {
+            if (!word.word().empty()) {
+                fields[std::min(count++, fields.size() - 1)] = word.word() == "-" ? "" : word.word();
+            }
+        }
+        if (count == 0) {
+            continue;
+        }
+        const auto pass = fields[0];
+        RuleSet *rules = pass == "consonant" ? &language.consonants : pass == "vowel" ? &language.vowels : nullptr;
+        if (rules == nullptr || count != 5 || !rules->add({fields[1], fields[2], fields[3], fields[4]})) {
+            error = "invalid rule on line " + std::to_string(number);
+            return false;
+        }
+    }
+    return true;
+}
+
+}
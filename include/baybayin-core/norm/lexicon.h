@@ -0,0 +1,344 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <baybayin-core/util/chars.h>
+#include <baybayin-core/util/utf8.h>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Words the rules get wrong, with how each normalizes, in a binary image that is used where it lies: a file is
+// mapped and looked up in place. The words are placed by a minimal perfect hash, so a lookup is one hash of the
+// word and one compare with the single entry it can be.
+//
+// Image layout, native byte order:
+//     LexiconHeader
+//     uint32_t pilots[buckets]  displaces the words of each bucket to their slots
+//     LexiconSlot slots[count]  one per word
+//     char pool[pool_size]      each word, lowercased, followed by its normalization
+
+namespace phil_norm {
+
+struct LexiconHeader {
+    std::array<char, 4> magic;
+    uint32_t version;
+    uint32_t count;
+    uint32_t buckets;
+    uint64_t seed;
+    uint32_t pool_size;
+    uint8_t min_word; // the length of the shortest and longest words, which no others are looked up past
+    uint8_t max_word;
+    uint16_t reserved;
+    uint64_t filter; // Lexicon::filter_bits of every word, to turn most other words away before hashing them
+};
+
+struct LexiconSlot {
+    uint32_t offset; // of the word in the pool, its normalization follows
+    uint8_t word_size;
+    uint8_t value_size;
+    uint16_t reserved;
+};
+
+/**
+ * @name Lexicon
+ * @brief A view of a lexicon image. It does not own the image, which has to outlive it.
+ */
+class Lexicon {
+public:
+    static constexpr std::array<char, 4> Magic = {'B', 'Y', 'L', 'X'};
+    static constexpr uint32_t Version = 1;
+    static constexpr size_t MaxWord = 64;
+    static constexpr size_t MaxValue = UINT8_MAX;
+
+private:
+    const uint32_t *pilots_ = nullptr;
+    const LexiconSlot *slots_ = nullptr;
+    const char *pool_ = nullptr;
+    uint64_t seed_ = 0;
+    uint32_t count_ = 0;
+    uint32_t buckets_ = 0;
+    uint32_t pool_size_ = 0;
+    uint8_t min_word_ = 0;
+    uint8_t max_word_ = 0;
+    uint64_t filter_ = 0;
+
+public:
+    /**
+     * @name hash
+     * @brief Hashes a lowercased word held in a buffer zero padded to a multiple of eight bytes past it.
+     */
+    [[nodiscard]] static uint64_t
+    hash(const char *word, const size_t size, const uint64_t seed) noexcept {
+        constexpr uint64_t multiplier = 0x9E3779B97F4A7C15;
+        uint64_t h = (seed ^ size) * multiplier;
+        for (size_t i = 0; i < size; i += 8) {
+            uint64_t chunk;
+            std::memcpy(&chunk, word + i, 8);
+            h = std::rotl((h ^ chunk) * multiplier, 29);
+        }
+        return h ^ h >> 32;
+    }
+
+    [[nodiscard]] static constexpr uint32_t
+    bucket(const uint64_t hash, const uint32_t buckets) noexcept {
+        return static_cast<uint32_t>((hash >> 32) * buckets >> 32);
+    }
+
+    [[nodiscard]] static constexpr uint32_t
+    slot(const uint64_t hash, const uint32_t pilot, const uint32_t count) noexcept {
+        uint64_t x = (hash ^ pilot * 0xBF58476D1CE4E5B9) * 0x94D049BB133111EB;
+        x ^= x >> 31;
+        return static_cast<uint32_t>((x >> 32) * count >> 32);
+    }
+
+    /**
+     * @name filter_bits
+     * @brief Two bits picked by the ends and length of a lowercased word.
+     */
+    [[nodiscard]] static constexpr uint64_t
+    filter_bits(const char first, const char last, const size_t size) noexcept {
+        const auto a = static_cast<uint8_t>(first);
+        const auto b = static_cast<uint8_t>(last);
+        return uint64_t{1} << ((a * 7 + b * 3 + size) & 63) | uint64_t{1} << ((a * 5 ^ b * 11 ^ size * 13) & 63);
+    }
+
+    Lexicon() = default;
+
+    /**
+     * @name load
+     * @brief Points the lexicon at an image, checking its header and size but not reading its entries, so loading
+     * takes the same time whatever the size of the lexicon.
+     * @param image Has to be aligned to 8 bytes, as a mapping or a std::string is
+     * @return false with error set if image is not a lexicon this version reads
+     */
+    bool
+    load(const std::string_view image, std::string &error) {
+        LexiconHeader header{};
+        if (image.size() < sizeof(header) || reinterpret_cast<uintptr_t>(image.data()) % 8 != 0) {
+            error = "not a lexicon";
+            return false;
+        }
+        std::memcpy(&header, image.data(), sizeof(header));
+        if (header.magic != Magic) {
+            error = "not a lexicon";
+            return false;
+        }
+        if (header.version != Version) {
+            error = "unsupported lexicon version " + std::to_string(header.version);
+            return false;
+        }
+        const size_t pilots = sizeof(header);
+        const size_t slots = pilots + (size_t{header.buckets} * sizeof(uint32_t) + 7) / 8 * 8;
+        const size_t pool = slots + size_t{header.count} * sizeof(LexiconSlot);
+        if ((header.count > 0 && header.buckets == 0) || image.size() != pool + header.pool_size) {
+            error = "truncated lexicon";
+            return false;
+        }
+        pilots_ = reinterpret_cast<const uint32_t *>(image.data() + pilots);
+        slots_ = reinterpret_cast<const LexiconSlot *>(image.data() + slots);
+        pool_ = image.data() + pool;
+        seed_ = header.seed;
+        count_ = header.count;
+        buckets_ = header.buckets;
+        pool_size_ = header.pool_size;
+        min_word_ = header.min_word;
+        max_word_ = header.max_word;
+        filter_ = header.filter;
+        return true;
+    }
+
+    [[nodiscard]] bool
+    empty() const noexcept {
+        return count_ == 0;
+    }
+
+    [[nodiscard]] size_t
+    size() const noexcept {
+        return count_;
+    }
+
+    /**
+     * @name find
+     * @brief Looks a word up in any case.
+     * @param value Set to its normalization if it is there
+     */
+    [[nodiscard]] bool
+    find(const std::string_view word, std::string_view &value) const noexcept {
+        if (word.size() < min_word_ || word.size() > max_word_ || word.size() > MaxWord || count_ == 0) {
+            return false;
+        }
+        if (const uint64_t bits = filter_bits(baybayin::ascii_lower(word.front()), baybayin::ascii_lower(word.back()),
+                                              word.size());
+            (filter_ & bits) != bits) {
+            return false;
+        }
+        std::array<char, MaxWord + 8> lower;
+        std::memset(lower.data() + word.size() / 8 * 8, 0, 8);
+        for (size_t i = 0; i < word.size(); ++i) {
+            lower[i] = baybayin::ascii_lower(word[i]);
+        }
+        const uint64_t h = hash(lower.data(), word.size(), seed_);
+        const LexiconSlot &entry = slots_[slot(h, pilots_[bucket(h, buckets_)], count_)];
+        // the image is not checked entry by entry on load, so a corrupt slot only misses
+        if (entry.word_size != word.size() || size_t{entry.offset} + entry.word_size + entry.value_size > pool_size_ ||
+            std::memcmp(pool_ + entry.offset, lower.data(), word.size()) != 0) {
+            return false;
+        }
+        value = {pool_ + entry.offset + entry.word_size, entry.value_size};
+        return true;
+    }
+};
+
+/**
+ * @name build_lexicon
+ * @brief Compiles words and their normalizations into a lexicon image. A word has to be a single word as Words
+ * splits text, of at most Lexicon::MaxWord bytes, and is matched in any case and folded as the input is, see
+ * baybayin::fold_latin. A normalization cannot be empty.
+ * @param image Replaced with the image
+ * @return false with error set, naming the word, if it is malformed, its normalization empty or too long, or it is
+ * repeated
+ */
+inline bool
+build_lexicon(const std::span<const std::pair<std::string_view, std::string_view>> entries, std::string &image,
+              std::string &error) {
+    using Buffer = std::array<char, Lexicon::MaxWord + 8>;
+    const auto count = static_cast<uint32_t>(entries.size());
+    std::vector<Buffer> words(count);
+    std::vector<size_t> lengths(count);
+    std::string folded;
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto &[raw, value] = entries[i];
+        const auto word = baybayin::fold_latin(raw, folded);
+        if (word.empty() || word.size() > Lexicon::MaxWord || value.empty() || value.size() > Lexicon::MaxValue ||
+            !std::ranges::all_of(word, baybayin::is_word_byte)) {
+            error = "invalid entry for \"" + std::string(raw) + "\"";
+            return false;
+        }
+        words[i] = {};
+        lengths[i] = word.size();
+        std::ranges::transform(word, words[i].begin(), baybayin::ascii_lower);
+    }
+    const auto word = [&](const uint32_t i) { return std::string_view(words[i].data(), lengths[i]); };
+
+    const uint32_t buckets = std::max<uint32_t>(1, count / 4);
+    std::vector<uint64_t> hashes(count);
+    std::vector<uint32_t> pilots(buckets);
+    std::vector<uint32_t> slots(count);
+    std::vector<uint32_t> order(count);
+    std::vector<bool> taken(count);
+    uint64_t seed = 0;
+    for (bool placed = count == 0; !placed; ++seed) {
+        for (uint32_t i = 0; i < count; ++i) {
+            hashes[i] = Lexicon::hash(words[i].data(), lengths[i], seed);
+        }
+        // the biggest buckets are placed first, while the table is still empty
+        std::vector<uint32_t> sizes(buckets);
+        for (uint32_t i = 0; i < count; ++i) {
+            ++sizes[Lexicon::bucket(hashes[i], buckets)];
+        }
+        std::iota(order.begin(), order.end(), 0);
+        std::ranges::sort(order, [&](const uint32_t a, const uint32_t b) {
+            const uint32_t bucket_a = Lexicon::bucket(hashes[a], buckets);
+            const uint32_t bucket_b = Lexicon::bucket(hashes[b], buckets);
+            return std::tie(sizes[bucket_b], bucket_a, hashes[a]) < std::tie(sizes[bucket_a], bucket_b, hashes[b]);
+        });
+        if (const auto same = std::ranges::adjacent_find(order, [&](const uint32_t a, const uint32_t b) {
+                return hashes[a] == hashes[b];
+            });
+            same != order.end()) {
+            if (word(*same) == word(*(same + 1))) {
+                error = "duplicate entry for \"" + std::string(entries[std::max(*same, *(same + 1))].first) + "\"";
+                return false;
+            }
+            continue; // two words hash the same, no pilot can tell them apart
+        }
+        taken.assign(count, false);
+        placed = true;
+        for (uint32_t start = 0; start < count && placed;) {
+            const uint32_t b = Lexicon::bucket(hashes[order[start]], buckets);
+            uint32_t end = start;
+            while (end < count && Lexicon::bucket(hashes[order[end]], buckets) == b) {
+                ++end;
+            }
+            placed = false;
+            for (uint32_t pilot = 0; pilot < (1u << 24) && !placed; ++pilot) {
+                uint32_t k = start;
+                for (; k < end && !taken[Lexicon::slot(hashes[order[k]], pilot, count)]; ++k) {
+                    slots[order[k]] = Lexicon::slot(hashes[order[k]], pilot, count);
+                    taken[slots[order[k]]] = true;
+                }
+                placed = k == end;
+                for (uint32_t undo = start; !placed && undo < k; ++undo) {
+                    taken[slots[order[undo]]] = false;
+                }
+                pilots[b] = pilot;
+            }
+            start = end;
+        }
+        if (placed) {
+            break;
+        }
+    }
+
+    LexiconHeader header{Lexicon::Magic, Lexicon::Version, count, buckets, seed, 0, Lexicon::MaxWord, 0, 0, 0};
+    std::vector<LexiconSlot> table(count);
+    std::string pool;
+    for (uint32_t i = 0; i < count; ++i) {
+        table[slots[i]] = {static_cast<uint32_t>(pool.size()), static_cast<uint8_t>(word(i).size()),
+                           static_cast<uint8_t>(entries[i].second.size()), 0};
+        pool.append(word(i));
+        pool.append(entries[i].second);
+        header.min_word = std::min(header.min_word, static_cast<uint8_t>(word(i).size()));
+        header.max_word = std::max(header.max_word, static_cast<uint8_t>(word(i).size()));
+        header.filter |= Lexicon::filter_bits(word(i).front(), word(i).back(), word(i).size());
+    }
+    header.pool_size = static_cast<uint32_t>(pool.size());
+    image.assign(reinterpret_cast<const char *>(&header), sizeof(header));
+    image.append(reinterpret_cast<const char *>(pilots.data()), pilots.size() * sizeof(uint32_t));
+    image.resize((image.size() + 7) / 8 * 8);
+    image.append(reinterpret_cast<const char *>(table.data()), table.size() * sizeof(LexiconSlot));
+    image.append(pool);
+    return true;
+}
+
+/**
+ * @name parse_lexicon
+ * @brief Compiles a word list into a lexicon image, one word per line followed by a tab and its normalization.
+ * Blank lines and lines starting with # are skipped.
+ * @return false with error set if a line is malformed, naming it, or an entry is as for build_lexicon
+ */
+inline bool
+parse_lexicon(const std::string_view text, std::string &image, std::string &error) {
+    std::vector<std::pair<std::string_view, std::string_view>> entries;
+    size_t number = 0;
+    for (size_t start = 0; start < text.size();) {
+        const size_t end = std::min(text.find('\n', start), text.size());
+        auto line = text.substr(start, end - start);
+        start = end + 1;
+        ++number;
+        if (line.ends_with('\r')) {
+            line.remove_suffix(1);
+        }
+        if (line.empty() || line.starts_with('#')) {
+            continue;
+        }
+        const size_t tab = line.find('\t');
+        if (tab == std::string_view::npos || line.find('\t', tab + 1) != std::string_view::npos) {
+            error = "invalid entry on line " + std::to_string(number);
+            return false;
+        }
+        entries.emplace_back(line.substr(0, tab), line.substr(tab + 1));
+    }
+    return build_lexicon(entries, image, error);
+}
+
+}
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <baybayin-core/util/chars.h>
+#include <baybayin-core/util/stats.h>
+#include <baybayin-core/util/util.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// The rule engine behind both normalization passes. A pass is a table of rewrite rules, compiled into a trie of
+// their patterns: at each byte with a rule the trie is walked as far as the text allows and the longest pattern
+// whose context holds is replaced. Bytes no rule matches are copied.
+
+namespace phil_norm {
+
+/**
+ * @name Rule
+ * @brief Rewrites pattern to replacement where the text around it matches before and after. Patterns match the
+ * text lowercased, so they are written in lowercase. Contexts are sequences of:
+ *  - a byte, matched lowercased
+ *  - V a vowel, C a consonant, N any byte but a vowel, . any byte
+ *  - ^ at the start of before: the context starts a word
+ *  - $ at the end of after: the context ends a word
+ * Among rules with the same pattern the first whose context holds wins.
+ */
+struct Rule {
+    std::string_view before;
+    std::string_view pattern;
+    std::string_view after;
+    std::string_view replacement;
+};
+
+// What the first byte of a pattern needs for one of its rules to apply
+enum RuleStart : uint8_t {
+    RuleStartAny = 1 << 0,
+    RuleStartWord = 1 << 1, // every rule for it needs the start of a word, e.g. mga
+};
+
+/**
+ * @name RuleSet
+ * @brief The rules of one pass, compiled into a trie held in fixed-size arrays. Built-in rule sets are compiled at
+ * compile time, rule files at load time, and neither allocates: a rule set is plain data.
+ */
+class RuleSet {
+public:
+    static constexpr size_t MaxRules = 64;
+    static constexpr size_t MaxNodes = 128;
+    static constexpr size_t MaxPattern = 8;
+    static constexpr size_t PoolBytes = 2048;
+    static_assert(MaxRules <= baybayin::StatsRuleSlots);
+
+private:
+    struct Text {
+        uint16_t offset = 0;
+        uint8_t size = 0;
+    };
+
+    // Index 0 of nodes_ and entries_ is unused, so 0 links to nothing
+    struct Node {
+        char byte = 0;
+        uint8_t child = 0;
+        uint8_t sibling = 0;
+        uint8_t entry = 0; // the first rule whose pattern ends here
+    };
+
+    struct Entry {
+        Text pattern; // as added, for rule()
+        Text before;
+        Text after;
+        Text replacement;
+        uint8_t next = 0; // the next rule with the same pattern
+    };
+
+    std::array<uint8_t, 256> root_{}; // node of each first byte
+    std::array<uint8_t, 256> starts_{};
+    std::array<Node, MaxNodes> nodes_{};
+    std::array<Entry, MaxRules> entries_{};
+    std::array<char, PoolBytes> pool_{};
+    uint8_t node_count_ = 1;
+    uint8_t entry_count_ = 1;
+    uint16_t pool_size_ = 0;
+    uint8_t growth_ = 1;
+    uint16_t reach_ = 0;
+    uint16_t behind_ = 0;
+
+    [[nodiscard]] constexpr std::string_view
+    text(const Text &text) const noexcept {
+        return {pool_.data() + text.offset, text.size};
+    }
+
+    constexpr Text
+    store(const std::string_view text) noexcept {
+        const Text stored{pool_size_, static_cast<uint8_t>(text.size())};
+        std::ranges::copy(text, pool_.begin() + pool_size_);
+        pool_size_ += text.size();
+        return stored;
+    }
+
+    static constexpr bool
+    valid_context(const std::string_view context, const char anchor) noexcept {
+        for (size_t k = 0; k < context.size(); ++k) {
+            const char c = context[k];
+            if ((c == '^' || c == '$') && (c != anchor || k != (anchor == '^' ? 0 : context.size() - 1))) {
+                return false;
+            }
+            if (c >= 'A' && c <= 'Z' && c != 'V' && c != 'C' && c != 'N') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static constexpr bool
+    matches(const char element, const char c) noexcept {
+        switch (element) {
+        case 'V':
+            return is_vowel(c);
+        case 'C':
+            return is_consonant(c);
+        case 'N':
+            return !is_vowel(c);
+        case '.':
+            return true;
+        default:
+            return element == c;
+        }
+    }
+
+    // word_start stands in for the text before pos, which the caller may know more about
+    [[nodiscard]] constexpr bool
+    before_holds(const std::string_view input, const size_t pos, const bool word_start,
+                 const std::string_view before
+    ) const noexcept {
+        size_t p = pos;
+        for (size_t k = before.size(); k-- > 0;) {
+            if (before[k] == '^') {
+                return (p == pos && word_start) || baybayin::is_word_start(input, p);
+            }
+            if (p == 0 || !matches(before[k], baybayin::ascii_lower(input[--p]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] static constexpr bool
+    after_holds(const std::string_view input, size_t pos, const std::string_view after) noexcept {
+        for (const char element : after) {
+            if (element == '$') {
+                return baybayin::is_word_end(input, pos);
+            }
+            if (pos >= input.size() || !matches(element, baybayin::ascii_lower(input[pos++]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    constexpr RuleSet() = default;
+
+    consteval explicit RuleSet(const std::span<const Rule> rules) {
+        for (const auto &rule : rules) {
+            if (!add(rule)) {
+                throw "invalid built-in rule";
+            }
+        }
+    }
+
+    /**
+     * @name add
+     * @brief Compiles one more rule in, after those already there.
+     * @return false, leaving the rule set as it was, if the rule is malformed or does not fit
+     */
+    constexpr bool
+    add(const Rule &rule) noexcept {
+        const auto &[before, pattern, after, replacement] = rule;
+        if (pattern.empty() || pattern.size() > MaxPattern || replacement.size() > UINT8_MAX ||
+            before.size() > UINT8_MAX || after.size() > UINT8_MAX || entry_count_ == MaxRules ||
+            node_count_ + pattern.size() > MaxNodes ||
+            pool_size_ + pattern.size() + before.size() + after.size() + replacement.size() > PoolBytes ||
+            std::ranges::any_of(pattern, [](const char c) { return c >= 'A' && c <= 'Z'; }) ||
+            !valid_context(before, '^') || !valid_context(after, '$')) {
+            return false;
+        }
+        uint8_t *link = &root_[static_cast<unsigned char>(pattern[0])];
+        uint8_t node = 0;
+        for (size_t k = 0; k < pattern.size(); ++k) {
+            while (*link != 0 && nodes_[*link].byte != pattern[k]) {
+                link = &nodes_[*link].sibling;
+            }
+            if (*link == 0) {
+                nodes_[node_count_].byte = pattern[k];
+                *link = node_count_++;
+            }
+            node = *link;
+            link = &nodes_[node].child;
+        }
+        const uint8_t entry = entry_count_++;
+        entries_[entry] = {store(pattern), store(before), store(after), store(replacement)};
+        link = &nodes_[node].entry;
+        while (*link != 0) {
+            link = &entries_[*link].next;
+        }
+        *link = entry;
+        const uint8_t start = before == "^" ? RuleStartWord : RuleStartAny;
+        starts_[static_cast<unsigned char>(pattern[0])] |= start;
+        if (baybayin::is_ascii_letter(pattern[0])) { // and its uppercase, so start can take bytes as written
+            starts_[static_cast<unsigned char>(pattern[0] & ~0x20)] |= start;
+        }
+        growth_ = std::max(growth_, static_cast<uint8_t>((replacement.size() + pattern.size() - 1) / pattern.size()));
+        reach_ = std::max(reach_, static_cast<uint16_t>(pattern.size() - 1 + after.size()));
+        behind_ = std::max(behind_, static_cast<uint16_t>(before.size()));
+        return true;
+    }
+
+    // RuleStart bits for rules starting with the byte c in either case, 0 for none
+    [[nodiscard]] constexpr uint8_t
+    start(const char c) const noexcept {
+        return starts_[static_cast<unsigned char>(c)];
+    }
+
+    [[nodiscard]] constexpr bool
+    empty() const noexcept {
+        return entry_count_ == 1;
+    }
+
+    // The number of rules added
+    [[nodiscard]] constexpr size_t
+    size() const noexcept {
+        return entry_count_ - 1;
+    }
+
+    // The rule added index-th, from 0
+    [[nodiscard]] constexpr Rule
+    rule(const size_t index) const noexcept {
+        const Entry &entry = entries_[index + 1];
+        return {text(entry.before), text(entry.pattern), text(entry.after), text(entry.replacement)};
+    }
+
+    // The most output bytes a rule writes per byte of input it consumes, at least one
+    [[nodiscard]] constexpr size_t
+    growth() const noexcept {
+        return growth_;
+    }
+
+    // How far past the first byte of a match its rules read, so a growing text can be run this far short of its end
+    [[nodiscard]] constexpr size_t
+    reach() const noexcept {
+        return reach_;
+    }
+
+    // How far before a match its rules read, the bytes to keep when dropping the front of a growing text
+    [[nodiscard]] constexpr size_t
+    behind() const noexcept {
+        return behind_;
+    }
+
+    /**
+     * @name apply
+     * @brief Rewrites the longest match at pos, or copies c if there is none.
+     * @param c The byte at pos, lowercased
+     * @tparam Pass The pass the rules are run for, which counts the rule applied under BAYBAYIN_STATS
+     * @param word_start Whether the caller has pos at the start of a word, on top of what the bytes before it say
+     * @return The number of following bytes consumed with it
+     */
+    template<baybayin::RulePass Pass, typename TOut>
+    [[gnu::always_inline]] size_t
+    apply(const std::string_view input, const size_t pos, const char c, const bool word_start,
+          TOut &output
+    ) const {
+        std::array<uint8_t, MaxPattern> path;
+        size_t depth = 0;
+        for (uint8_t node = root_[static_cast<unsigned char>(c)]; node != 0;) {
+            path[depth++] = node;
+            if (pos + depth >= input.size()) {
+                break;
+            }
+            const char next = baybayin::ascii_lower(input[pos + depth]);
+            for (node = nodes_[node].child; node != 0 && nodes_[node].byte != next;) {
+                node = nodes_[node].sibling;
+            }
+        }
+        for (; depth > 0; --depth) {
+            for (uint8_t e = nodes_[path[depth - 1]].entry; e != 0; e = entries_[e].next) {
+                const Entry &entry = entries_[e];
+                if (before_holds(input, pos, word_start, text(entry.before)) &&
+                    after_holds(input, pos + depth, text(entry.after))) {
+                    const auto replacement = text(entry.replacement);
+                    output.append(replacement.data(), replacement.size());
+                    baybayin::count_rule<Pass>(e - 1);
+                    return depth - 1;
+                }
+            }
+        }
+        output.push_back(c);
+        return 0;
+    }
+};
+
+}
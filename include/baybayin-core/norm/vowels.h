@@ -1,232 +1,253 @@
 #pragma once
 
+#include <algorithm>
+#include <baybayin-core/norm/dispatch.h>
+#include <baybayin-core/norm/languages.h>
+#include <baybayin-core/norm/rules.h>
+#include <baybayin-core/util/chars.h>
+#include <baybayin-core/util/scan.h>
+#include <baybayin-core/util/stats.h>
 #include <baybayin-core/util/util.h>
+#include <baybayin-core/util/writer.h>
+#include <bit>
+#include <cstdint>
 #include <string>
 #include <string_view>
 
 using namespace phil_norm;
 
-template<ForeignLanguage TLang, LatinOrthography TOrtho> // TODO: templated for diphthong?
-[[gnu::always_inline]] size_t
-a_normalizer(const std::string_view &input, const size_t pos, std::string &output) {
-    size_t count = 0;
-    switch (TLang) {
-    case ForeignLanguage::SPANISH:
-        switch (TOrtho) {
-        case LatinOrthography::ABAKADA:
-            output.push_back('a');
-            break;
-        case LatinOrthography::ALPABETONG:
-            output.push_back('a');
-            break;
-        }
-        break;
-    case ForeignLanguage::ENGLISH:
-        switch (TOrtho) {
-        case LatinOrthography::ABAKADA:
-            if (const size_t next = pos + 1;
-                next < input.size() and std::ranges::count(std::to_array({'i', 'y'}), input[next])) {
-                output.append("ey");
-                count++;
-                break;
-            }
-            if (const size_t next = pos + 1;
-                next < input.size() and std::ranges::count(std::to_array({'u', 'w'}), input[next])) {
-                output.push_back('o');
-                count++;
-                break;
-            }
-            if (const size_t next = pos + 1;
-                next < input.size() and std::ranges::count(std::to_array({'e'}), input[next])) {
-                output.push_back('o');
-                count++;
-                break;
-            }
-            if (const size_t next = pos + 1;
-                next < input.size() and is_consonant(input[next]) and next + 1 < input.size() and input[next + 1] ==
-                'e') {
-                output.append("ey");
-                break;
-            }
-            output.push_back('a');
-            break;
-        case LatinOrthography::ALPABETONG:
-            output.push_back('a');
-            break;
-        }
-    }
-    return count;
+// Bytes cluster_vowel reads past the consonant starting a cluster, the liquid or glide and the vowel after it
+inline constexpr size_t ClusterReach = 2;
+
+// The liquids and glides that make a cluster after a consonant, lowercase
+constexpr bool
+is_cluster_second(const char c) noexcept {
+    return c == 'l' || c == 'r' || c == 'w' || c == 'y';
 }
 
-template<ForeignLanguage TLang, LatinOrthography TOrtho> // TODO: templated for diphthong?
-[[gnu::always_inline]] size_t
-o_normalizer(const std::string_view &input, const size_t pos, std::string &output) {
-    size_t count = 0;
-    switch (TLang) {
-    case ForeignLanguage::SPANISH:
-        switch (TOrtho) {
-        case LatinOrthography::ABAKADA:
-            output.push_back('o');
-            break;
-        case LatinOrthography::ALPABETONG:
-            output.push_back('o');
-            break;
-        }
-        break;
-    case ForeignLanguage::ENGLISH:
-        switch (TOrtho) {
-        case LatinOrthography::ABAKADA:
-            if (const size_t next = pos + 1;
-                next < input.size() and std::ranges::count(std::to_array({'a'}), input[next])) {
-                output.push_back('o');
-                count++;
-                break;
-            }
-            output.push_back('o');
-            break;
-        case LatinOrthography::ALPABETONG:
-            output.push_back('o');
-            break;
-        }
+/**
+ * @name cluster_vowel
+ * @brief The vowel the traditional spelling puts into a consonant cluster starting a word at pos: the vowel after
+ * an l or r (plano, palano; tren, teren), u before a w (kwento, kuwento) and i before a y (dyos, diyos). Reads
+ * ClusterReach bytes past pos and the one before it.
+ * @return The vowel, lowercased, or 0 if no cluster starts at pos
+ */
+constexpr char
+cluster_vowel(const std::string_view &input, const size_t pos) noexcept {
+    if (pos + ClusterReach >= input.size() || (pos > 0 && baybayin::is_word_byte(input[pos - 1]))) {
+        return 0;
+    }
+    const char first = baybayin::ascii_lower(input[pos]);
+    const char next = baybayin::ascii_lower(input[pos + 2]);
+    if (!is_consonant(first) || !is_vowel(next) || is_cluster_second(first)) {
+        return 0;
+    }
+    switch (baybayin::ascii_lower(input[pos + 1])) {
+        case 'l':
+        case 'r':
+            return next;
+        case 'w':
+            return 'u';
+        case 'y':
+            return 'i';
+        default:
+            return 0;
     }
-    return count;
 }
 
-template<ForeignLanguage TLang, LatinOrthography TOrtho> // TODO: templated for diphthong?
-[[gnu::always_inline]] size_t
-e_normalizer(const std::string_view &input, const size_t pos, std::string &output) {
-    size_t count = 0;
-    switch (TLang) {
-    case ForeignLanguage::SPANISH:
-        switch (TOrtho) {
-        case LatinOrthography::ABAKADA:
-            output.push_back('e');
-            break;
-        case LatinOrthography::ALPABETONG:
-            output.push_back('e');
-            break;
-        }
-        break;
-    case ForeignLanguage::ENGLISH:
-        switch (TOrtho) {
-        case LatinOrthography::ABAKADA:
-            if (const size_t next = pos + 1; // todo: make this use a boundary function for words
-                next == input.size() or std::isspace(input[next])) {
-                break;
-            }
-            if (const size_t next = pos + 1;
-                next < input.size() and input[next] == 'e') {
-                output.push_back('i');
-                count++;
-                break;
-            }
-            output.push_back('e');
-            break;
-        case LatinOrthography::ALPABETONG:
-            output.push_back('e');
-            break;
-        }
-        break;
+/**
+ * @name ClusterBits
+ * @brief One bit per byte of up to 64 bytes: the bytes that are not a letter, every separator among them, and the
+ * liquids and glides. A cluster can only start after the one and before the other.
+ */
+struct ClusterBits {
+    uint64_t other = 0;
+    uint64_t second = 0;
+};
+
+/**
+ * @name cluster_bits
+ * @brief The ClusterBits of the width bytes at data, a vector at a time where one fits and a byte at a time past it.
+ * Lowercasing a byte as c | 0x20 is exact for comparing against a lowercase letter, so no full scan block is built.
+ */
+[[gnu::always_inline]] inline ClusterBits
+cluster_bits(const char *data, const size_t width) noexcept {
+    ClusterBits bits;
+    size_t k = 0;
+#if !defined(BAYBAYIN_SCALAR_SCAN) && defined(__AVX2__)
+    for (; k + sizeof(__m256i) <= width; k += sizeof(__m256i)) {
+        const __m256i l = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + k)),
+                                          _mm256_set1_epi8(0x20));
+        const auto equals = [l](const char c) { return _mm256_cmpeq_epi8(l, _mm256_set1_epi8(c)); };
+        const auto mask = [k](const __m256i v) {
+            return uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(v))} << k;
+        };
+        // signed, so the bytes outside ASCII count too
+        const __m256i other = _mm256_or_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8('a'), l),
+                                              _mm256_cmpgt_epi8(l, _mm256_set1_epi8('z')));
+        const __m256i second =
+            _mm256_or_si256(_mm256_or_si256(equals('l'), equals('r')), _mm256_or_si256(equals('w'), equals('y')));
+        bits.other |= mask(other);
+        bits.second |= mask(second);
+    }
+#elif !defined(BAYBAYIN_SCALAR_SCAN) && defined(__SSE2__)
+    for (; k + sizeof(__m128i) <= width; k += sizeof(__m128i)) {
+        const __m128i l =
+            _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + k)), _mm_set1_epi8(0x20));
+        const auto equals = [l](const char c) { return _mm_cmpeq_epi8(l, _mm_set1_epi8(c)); };
+        const auto mask = [k](const __m128i v) {
+            return uint64_t{static_cast<uint32_t>(_mm_movemask_epi8(v))} << k;
+        };
+        // signed, so the bytes outside ASCII count too
+        const __m128i other =
+            _mm_or_si128(_mm_cmplt_epi8(l, _mm_set1_epi8('a')), _mm_cmpgt_epi8(l, _mm_set1_epi8('z')));
+        const __m128i second =
+            _mm_or_si128(_mm_or_si128(equals('l'), equals('r')), _mm_or_si128(equals('w'), equals('y')));
+        bits.other |= mask(other);
+        bits.second |= mask(second);
     }
-    return count;
+#endif
+    for (; k < width; ++k) {
+        const auto c = static_cast<signed char>(data[k] | 0x20);
+        bits.other |= uint64_t{c < 'a' || c > 'z'} << k;
+        bits.second |= uint64_t{is_cluster_second(c)} << k;
+    }
+    return bits;
 }
 
 /**
- * @name vowel_normalize
- * @brief
- * @tparam TLang
- * @tparam TOrtho
- * @tparam TDipht
- * @param input
- * @param output
+ * @name cluster_mask
+ * @brief The clusters starting among the width bytes of input from pos, at most 64, as a bit mask. cluster_bits
+ * narrows them down a vector at a time to the bytes after no letter and before a liquid or glide, about twice as
+ * many as there are clusters, and only those are looked at with cluster_vowel. The first byte is always looked at,
+ * what comes before it being outside the block, and so are the last ClusterReach, whose cluster would end past it.
  */
-template<ForeignLanguage TLang, LatinOrthography TOrtho, Diphthong TDipht>
-[[gnu::always_inline]] void
-vowel_normalize(const std::string_view &input, std::string &output) {
-    output.reserve(input.size());
-    for (size_t i = 0; i < input.size(); ++i) {
-        switch (const char c = input[i]) {
-        case 'a':
-            i += a_normalizer<TLang, TOrtho>(input, i, output);
-            break;
-        case 'e':
-            i += e_normalizer<TLang, TOrtho>(input, i, output);
-            break;
-        case 'i':
-            output.push_back('i');
-            break;
-        case 'o':
-            i += o_normalizer<TLang, TOrtho>(input, i, output);
-            break;
-        case 'u':
-            output.push_back('u');
-            break;
-        case 'y': default:
-            output.push_back(c);
-            break;
-        }
+[[gnu::always_inline]] inline uint64_t
+cluster_mask(const std::string_view &input, const size_t pos, const size_t width) {
+    const ClusterBits bits = cluster_bits(input.data() + pos, width);
+    const size_t inner = width < ClusterReach ? 0 : width - ClusterReach;
+    const uint64_t starts = bits.other << 1 | 1;
+    uint64_t mask = 0;
+    for (uint64_t found = starts & bits.second >> 1 & ((uint64_t{1} << inner) - 1); found != 0; found &= found - 1) {
+        const size_t k = static_cast<size_t>(std::countr_zero(found));
+        mask |= uint64_t{cluster_vowel(input, pos + k) != 0} << k;
     }
+    for (size_t k = inner; k < width; ++k) {
+        mask |= uint64_t{(starts >> k & 1) && cluster_vowel(input, pos + k) != 0} << k;
+    }
+    return mask;
+}
+
+// How far past and before a byte the vowel pass reads, and the most it writes for it, with the clusters it makes
+template<InitialCluster Clusters>
+constexpr size_t
+vowel_reach(const RuleSet &rules) noexcept {
+    return Clusters == InitialCluster::TRADITIONAL ? std::max(rules.reach(), ClusterReach) : rules.reach();
+}
+
+template<InitialCluster Clusters>
+constexpr size_t
+vowel_behind(const RuleSet &rules) noexcept {
+    return Clusters == InitialCluster::TRADITIONAL ? std::max<size_t>(rules.behind(), 1) : rules.behind();
+}
+
+template<InitialCluster Clusters>
+constexpr size_t
+vowel_growth(const RuleSet &rules) noexcept {
+    return Clusters == InitialCluster::TRADITIONAL ? std::max<size_t>(rules.growth(), 2) : rules.growth();
 }
 
-inline void
-vowel_normalize_dispatch(const std::string_view &input, std::string &output, const ForeignLanguage lang,
-                         const LatinOrthography ortho, const Diphthong dipht
+/**
+ * @name vowel_normalize_range
+ * @brief Runs the vowel pass of rules over input[pos, end), appending to output. Bytes no rule starts with are
+ * found 64 at a time and copied a run at a time. Rules read up to rules.reach() bytes past where they start and
+ * rules.behind() before it, so a text that is still growing can be run up to reach() bytes short of its end, and
+ * its front dropped up to behind() bytes short of where the pass stopped; vowel_reach and vowel_behind give the
+ * same with the clusters.
+ * @tparam Clusters TRADITIONAL to break up the consonant clusters starting words, see cluster_vowel. A cluster
+ * takes precedence over a rule starting with the same consonant.
+ * @return Where the pass stopped, end or past it when the last rule consumed the bytes after it
+ */
+template<InitialCluster Clusters = InitialCluster::REFORMED, typename TOut>
+[[gnu::always_inline]] inline size_t
+vowel_normalize_range(const std::string_view &input, size_t pos, const size_t end, const RuleSet &rules,
+                      TOut &output
 ) {
-    switch (lang) {
-    case ForeignLanguage::SPANISH:
-        switch (ortho) {
-        case LatinOrthography::ABAKADA:
-            switch (dipht) {
-            case Diphthong::TRADITIONAL:
-                vowel_normalize<ForeignLanguage::SPANISH, LatinOrthography::ABAKADA, Diphthong::TRADITIONAL>(
-                input, output);
-                break;
-            case Diphthong::REFORMED:
-                vowel_normalize<ForeignLanguage::SPANISH, LatinOrthography::ABAKADA,
-                                Diphthong::REFORMED>(input, output);
-                break;
-            }
-            break;
-        case LatinOrthography::ALPABETONG:
-            switch (dipht) {
-            case Diphthong::TRADITIONAL:
-                vowel_normalize<ForeignLanguage::SPANISH, LatinOrthography::ALPABETONG, Diphthong::TRADITIONAL>(
-                input, output);
-                break;
-            case Diphthong::REFORMED:
-                vowel_normalize<ForeignLanguage::SPANISH, LatinOrthography::ALPABETONG, Diphthong::REFORMED>(
-                input, output);
-                break;
-            }
-            break;
+    const baybayin::StageTimer<baybayin::Stage::Vowels> timer;
+    constexpr bool clusters = Clusters == InitialCluster::TRADITIONAL;
+    if (!clusters && rules.empty()) {
+        output.append(input.data() + pos, end - pos);
+        return end;
+    }
+    while (pos < end) {
+        const size_t width = std::min<size_t>(64, end - pos);
+        const size_t block = pos;
+        const size_t block_end = pos + width;
+        uint64_t ruled = 0;
+        for (size_t k = 0; k < width && !(clusters && rules.empty()); ++k) {
+            ruled |= uint64_t{rules.start(input[pos + k]) != 0} << k;
         }
-        break;
-    case ForeignLanguage::ENGLISH:
-        switch (ortho) {
-        case LatinOrthography::ABAKADA:
-            switch (dipht) {
-            case Diphthong::TRADITIONAL:
-                vowel_normalize<ForeignLanguage::ENGLISH, LatinOrthography::ABAKADA, Diphthong::TRADITIONAL>(
-                input, output);
-                break;
-            case Diphthong::REFORMED:
-                vowel_normalize<ForeignLanguage::ENGLISH, LatinOrthography::ABAKADA,
-                                Diphthong::REFORMED>(input, output);
-                break;
-            }
-            break;
-        case LatinOrthography::ALPABETONG:
-            switch (dipht) {
-            case Diphthong::TRADITIONAL:
-                vowel_normalize<ForeignLanguage::ENGLISH, LatinOrthography::ALPABETONG, Diphthong::TRADITIONAL>(
-                input, output);
-                break;
-            case Diphthong::REFORMED:
-                vowel_normalize<ForeignLanguage::ENGLISH, LatinOrthography::ALPABETONG, Diphthong::REFORMED>(
-                input, output);
-                break;
+        // the clusters, by offset in the block, kept apart so only the bytes that start one are looked at again
+        uint64_t clustered = 0;
+        if constexpr (clusters) {
+            clustered = cluster_mask(input, pos, width);
+            ruled |= clustered;
+        }
+        while (ruled != 0 && pos < block_end) {
+            const size_t run = std::countr_zero(ruled);
+            output.append(input.data() + pos, run);
+            pos += run;
+            size_t consumed = 1;
+            if (const char vowel = clusters && (clustered >> (pos - block) & 1) ? cluster_vowel(input, pos) : 0;
+                vowel != 0) {
+                output.push_back(input[pos]);
+                output.push_back(vowel);
+            } else {
+                consumed += rules.apply<baybayin::RulePass::Vowels>(input, pos, baybayin::ascii_lower(input[pos]),
+                                                                    false, output);
             }
-            break;
+            pos += consumed;
+            ruled = run + consumed < 64 ? ruled >> (run + consumed) : 0;
+        }
+        if (pos < block_end) {
+            output.append(input.data() + pos, block_end - pos);
+            pos = block_end;
         }
     }
+    return pos;
+}
+
+/**
+ * @name vowel_normalize
+ * @brief Runs the vowel pass of rules over input, the output of the consonant pass, appending to output.
+ */
+template<InitialCluster Clusters = InitialCluster::REFORMED, baybayin::CharString TString>
+void
+vowel_normalize(const std::string_view &input, TString &output, const RuleSet &rules) {
+    // a cluster adds a vowel, and few words start with one: room for one every eight bytes saves regrowing
+    output.reserve(Clusters == InitialCluster::TRADITIONAL ? input.size() + input.size() / 8 : input.size());
+    vowel_normalize_range<Clusters>(input, 0, input.size(), rules, output);
+}
+
+template<ForeignLanguage LanguageId, LatinOrthography OrthographyId, InitialCluster Clusters,
+         typename TString = std::string>
+struct VowelNormalizeEntry {
+    static void
+    run(const std::string_view &input, TString &output) {
+        vowel_normalize<Clusters>(input, output, BuiltinLanguage<LanguageId, OrthographyId>.vowels);
+    }
+};
+
+/**
+ * @name vowel_normalize_dispatch
+ * @brief Runs the built-in vowel pass for the runtime parameters provided, through DispatchTable. No built-in rule
+ * depends on dipht yet.
+ */
+template<baybayin::CharString TString>
+void
+vowel_normalize_dispatch(const std::string_view &input, TString &output, const ForeignLanguage lang,
+                         const LatinOrthography ortho, [[maybe_unused]] const Diphthong dipht,
+                         const InitialCluster clusters
+) {
+    DispatchTable<VowelNormalizeEntry, TString>[configuration_index(lang, ortho, clusters)](input, output);
 }
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <baybayin-core/norm.h>
+#include <baybayin-core/tl.h>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+// Raw Latin text to Baybayin in one pass: the consonant pass, the vowel pass and the transliteration core are run
+// a window at a time, handing each other only the bytes that are complete. The buffers between the stages hold a
+// window plus the few bytes of lookahead the next stage is waiting on, never a whole intermediate text.
+
+namespace baybayin {
+
+// Input bytes run through the consonant pass before the later stages are drained
+inline constexpr size_t PipelineWindow = 8 * ScanWidth;
+
+/**
+ * @name normalize_transliterate
+ * @brief Normalizes input with the rules of language and transliterates the result into sink, as
+ * latin_to_baybayin(normalizer(input)) would.
+ * @tparam Clusters As for phil_norm::vowel_normalize_range
+ * @param consonants Scratch buffer between the consonant and vowel passes
+ * @param vowels Scratch buffer between the vowel pass and transliteration
+ */
+template<InitialCluster Clusters = InitialCluster::REFORMED, typename TSink, CharString TString>
+void
+normalize_transliterate(const std::string_view input, TSink &sink, const phil_norm::Language &language,
+                        const Orthography ortho, const Virama style, TString &consonants, TString &vowels
+) {
+    consonants.clear();
+    vowels.clear();
+    StringWriter staged(consonants);
+    StringWriter vowelled(vowels);
+    ConsonantState state;
+    size_t done = 0;
+    size_t i = 0;
+    while (i < input.size()) {
+        const size_t window = i + PipelineWindow;
+        while (i < input.size() && i < window) {
+            i = fast_consonant_block(input, i, state, language.consonants, staged);
+        }
+        // the vowel pass waits for its lookahead, the rest of the window for the next one
+        vowel_normalize_staged<Clusters>(staged, done, language.vowels, vowelled);
+        vowelled.erase_front(transliterate(vowelled.view(), sink, ortho, style, false));
+    }
+    staged.reserve(state.pending_spaces);
+    consonant_normalize_finish(state, staged);
+    const auto text = staged.view();
+    vowelled.reserve(vowel_growth<Clusters>(language.vowels) * (text.size() - done));
+    vowel_normalize_range<Clusters>(text, done, text.size(), language.vowels, vowelled);
+    transliterate(vowelled.view(), sink, ortho, style);
+}
+
+template<ForeignLanguage LanguageId, LatinOrthography OrthographyId, InitialCluster Clusters,
+         typename TString = std::string>
+struct NormalizeTransliterateEntry {
+    static void
+    run(const std::string_view input, StringSink<TString> &sink, const Orthography ortho, const Virama style,
+        TString &consonants, TString &vowels) {
+        normalize_transliterate<Clusters>(input, sink, phil_norm::BuiltinLanguage<LanguageId, OrthographyId>, ortho,
+                                          style, consonants, vowels);
+    }
+};
+
+/**
+ * @name NormalizingTransliterator
+ * @brief The fused pipeline configured once. It keeps its stage buffers between calls, so once they have grown to
+ * a window a call allocates nothing beyond the output.
+ */
+class NormalizingTransliterator {
+    decltype(phil_norm::DispatchTable<NormalizeTransliterateEntry>)::value_type pipeline_;
+    const phil_norm::Language *language_;
+    Orthography ortho_;
+    Virama style_;
+    uint32_t tag_;
+    std::string space_;
+    std::string consonants_;
+    std::string vowels_;
+    std::string folded_;
+    std::string miss_;
+
+    void
+    transliterate_folded(const std::string_view input, std::string &out) {
+        StringSink sink(out);
+        sink.reserve(input.size() * 3);
+        pipeline_(input, sink, ortho_, style_, consonants_, vowels_);
+        sink.finish();
+    }
+
+public:
+    NormalizingTransliterator(const ForeignLanguage language, const LatinOrthography orthography,
+                              const Diphthong diphthongs, const InitialCluster clusters,
+                              const Orthography ortho = Orthography::Reformed, const Virama style = Virama::Krus
+    ) : pipeline_(phil_norm::DispatchTable<NormalizeTransliterateEntry>[
+            phil_norm::configuration_index(language, orthography, clusters)]),
+        language_(&phil_norm::builtin_language(language, orthography)), ortho_(ortho), style_(style),
+        tag_(CachePipeline | phil_norm::configuration_tag(language, orthography, diphthongs, clusters) |
+             static_cast<uint32_t>(ortho) << 16 | static_cast<uint32_t>(style) << 18),
+        space_(latin_to_baybayin(" ", ortho, style)) {
+    }
+
+    /**
+     * @name transliterate
+     * @brief Appends the Baybayin for one complete text to out, its UTF-8 folded first as the normalizer does.
+     */
+    void
+    transliterate(const std::string_view input, std::string &out) {
+        transliterate_folded(fold_latin(input, folded_), out);
+    }
+
+    /**
+     * @name transliterate
+     * @brief Appends the Baybayin for one complete text to out, a word at a time through cache. The normalized text
+     * only breaks into separately transliterated runs at the spaces between words, so each word's Baybayin can be
+     * cached whole.
+     */
+    void
+    transliterate(const std::string_view input, std::string &out, WordCache &cache) {
+        if (cache.bypass(input.size())) {
+            transliterate(input, out);
+            return;
+        }
+        const auto folded = fold_latin(input, folded_);
+        phil_norm::normalize_words(folded, out, cache, miss_, tag_,
+                                   [this](const std::string_view &text, std::string &word) {
+            const size_t mark = word.size();
+            transliterate_folded(text, word);
+            return word.size() > mark || phil_norm::consonants_emit(text, language_->consonants, consonants_);
+        }, space_);
+    }
+};
+
+/**
+ * @name normalize_to_baybayin
+ * @brief Normalizes and transliterates raw Latin text in one pass, appending to out, its UTF-8 folded first. The
+ * stage buffers are allocated as out is. As for phil_norm::fast_normalize_dispatch, no built-in rule depends on
+ * diphthongs yet.
+ */
+template<CharString TString>
+void
+normalize_to_baybayin(const std::string_view input, TString &out, const ForeignLanguage language,
+                      const LatinOrthography orthography, [[maybe_unused]] const Diphthong diphthongs,
+                      const InitialCluster clusters, const Orthography ortho = Orthography::Reformed,
+                      const Virama style = Virama::Krus
+) {
+    TString folded(out.get_allocator());
+    TString consonants(out.get_allocator());
+    TString vowels(out.get_allocator());
+    StringSink sink(out);
+    sink.reserve(input.size() * 3);
+    phil_norm::DispatchTable<NormalizeTransliterateEntry, TString>[
+        phil_norm::configuration_index(language, orthography, clusters)](fold_latin(input, folded), sink, ortho, style,
+                                                                         consonants, vowels);
+    sink.finish();
+}
+
+/**
+ * @name normalize_to_baybayin
+ * @brief Normalizes and transliterates raw Latin text in one pass.
+ */
+inline std::string
+normalize_to_baybayin(const std::string_view input, const ForeignLanguage language,
+                      const LatinOrthography orthography, const Diphthong diphthongs, const InitialCluster clusters,
+                      const Orthography ortho = Orthography::Reformed, const Virama style = Virama::Krus
+) {
+    std::string out;
+    normalize_to_baybayin(input, out, language, orthography, diphthongs, clusters, ortho, style);
+    return out;
+}
+
+/**
+ * @name normalize_to_baybayin
+ * @brief Normalizes and transliterates raw Latin text in one pass, into a string allocated from resource.
+ */
+inline std::pmr::string
+normalize_to_baybayin(const std::string_view input, std::pmr::memory_resource *resource,
+                      const ForeignLanguage language, const LatinOrthography orthography, const Diphthong diphthongs,
+                      const InitialCluster clusters, const Orthography ortho = Orthography::Reformed,
+                      const Virama style = Virama::Krus
+) {
+    std::pmr::string out(resource);
+    normalize_to_baybayin(input, out, language, orthography, diphthongs, clusters, ortho, style);
+    return out;
+}
+
+} // namespace baybayin
@@ -1,190 +1,457 @@
 #pragma once
 
+#include <algorithm>
+#include <baybayin-core/tl/glyphs.h>
+#include <baybayin-core/tl/output.h>
+#include <baybayin-core/util/batch.h>
+#include <baybayin-core/util/cache.h>
+#include <baybayin-core/util/chars.h>
+#include <baybayin-core/util/scan.h>
+#include <baybayin-core/util/stats.h>
+#include <baybayin-core/util/writer.h>
+#include <bit>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
 #include <string>
 #include <string_view>
 
 namespace baybayin {
 
-enum class Orthography {
-    // NOTES: https://luffykudo.wordpress.com/2020/08/10/how-to-read-and-write-baybayin/
-    Traditional, // Pre-colonial: no ending consonants for syllables (or words)
-    Reformed,    // Added ending consonants for syllables (and words), adds word spacing, | as comma,
-    Modern       // Suggestions (added additional sounds:  f, j, v, z ??
-};
-
-enum class Virama {
-    Krus,    // Standard Spanish "+"
-    Pamudpod // Modern curved slash style "᜴ "
-};
+/**
+ * @name transliterate
+ * @brief The transliteration core. The input is classified ScanWidth bytes at a time, then each consonant is looked
+ * up together with the vowel following it in SyllableTable, so a syllable is emitted as a single fixed-size copy of
+ * pre-encoded bytes. Runs of bytes without a glyph are skipped whole.
+ * @tparam TOrtho Output orthography
+ * @tparam TStyle Virama used for codas
+ * @tparam TSink StringSink, SpanSink or CountingSink
+ * @param in Normalized Latin input
+ * @param sink Output
+ * @param last Whether in ends the text. Otherwise a consonant whose following bytes are not in yet is left for the
+ * next call.
+ * @return The number of bytes of in consumed, all of them when last is set
+ */
+template<Orthography TOrtho, Virama TStyle, typename TSink>
+size_t
+transliterate(const std::string_view in, TSink &sink, const bool last = true) {
+    constexpr size_t BlockCapacity = ScanWidth * sizeof(Glyph::bytes);
+    constexpr auto &syllables = SyllableTable[static_cast<size_t>(TOrtho)][static_cast<size_t>(TStyle)];
+    constexpr auto &punctuation = PunctuationTable[static_cast<size_t>(TOrtho)];
+    const size_t n = in.size();
+    const StageTimer<Stage::Transliterate> timer;
 
-inline char
-ascii_lower(char c) noexcept {
-    return (c >= 'A' && c <= 'Z') ? (c | 0x20) : c;
-}
+    ScanBlock block;
+    for (size_t base = 0; base < n;) {
+        const size_t width = std::min(ScanWidth, n - base);
+        scan_block(in.data() + base, width, block);
+        sink.reserve(BlockCapacity);
+        const auto [vowels, consonants, spaces, punctuations, non_ascii] = block.masks;
+        const uint32_t glyphs = vowels | consonants | spaces | punctuations;
+        // the NG digraph and the vowel after a consonant are looked up to two bytes ahead, stop early enough to
+        // keep them inside this block unless it is the last one
+        const size_t end = base + width == n ? width : width - 2;
 
-inline bool
-is_vowel(char c) noexcept {
-    return c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u';
+        size_t k = 0;
+        while (k < end) {
+            const uint32_t bit = uint32_t{1} << k;
+            // --- Standalone Vowel ---
+            if (vowels & bit) {
+                count_glyphs<GlyphClass::Vowel>();
+                sink.emit(syllables[0][LatinClasses[static_cast<unsigned char>(block.lower[k++])].index]);
+                continue;
+            }
+            // --- Consonant Cluster / Coda ---
+            if (consonants & bit) {
+                const auto [kind, index] = LatinClasses[static_cast<unsigned char>(block.lower[k])];
+                if (kind != LatinKind::Consonant) {
+                    count_glyphs<GlyphClass::Skipped>();
+                    ++k;
+                    continue; // not part of the abugida (c, f, j, q, v, x, z)
+                }
+                auto consonant = static_cast<Consonant>(index);
+                if (!last && (base + k + 1 == n || (base + k + 2 == n && consonant == Consonant::N &&
+                                                    block.lower[k + 1] == 'g'))) {
+                    return base + k; // the vowel or the NG digraph may be in the next chunk
+                }
+                ++k;
+                if (consonant == Consonant::N && k < width && block.lower[k] == 'g') {
+                    consonant = Consonant::NG;
+                    ++k;
+                }
+                auto vowel = VowelClass::None;
+                if (k < width && vowels & uint32_t{1} << k) {
+                    vowel = static_cast<VowelClass>(LatinClasses[static_cast<unsigned char>(block.lower[k++])].index);
+                    count_glyphs<GlyphClass::Syllable>();
+                } else {
+                    count_glyphs<GlyphClass::Coda>();
+                }
+                sink.emit(syllables[static_cast<size_t>(consonant)][static_cast<size_t>(vowel)]);
+                continue;
+            }
+            if ((spaces | punctuations) & bit) {
+                count_glyphs<GlyphClass::Punctuation>();
+                sink.emit(punctuation[LatinClasses[static_cast<unsigned char>(block.lower[k++])].index]);
+                continue;
+            }
+            // Non-alphabetic, skip to the next byte with a glyph
+            const uint32_t ahead = glyphs >> k;
+            const size_t next = ahead ? k + std::countr_zero(ahead) : width;
+            count_glyphs<GlyphClass::Skipped>(next - k);
+            k = next;
+        }
+        base += k;
+    }
+    return n;
 }
 
-inline void
-emit_vowel(std::string &out, char v) {
-    switch (v) {
-    case 'a':
-        out += "ᜀ";
+/**
+ * @name transliterate
+ * @brief Calls the transliteration core specialized for the runtime parameters provided.
+ */
+template<typename TSink>
+size_t
+transliterate(const std::string_view in, TSink &sink, const Orthography ortho, const Virama style,
+              const bool last = true
+) {
+    switch (ortho) {
+    case Orthography::Traditional:
+        switch (style) {
+        case Virama::Krus:
+            return transliterate<Orthography::Traditional, Virama::Krus>(in, sink, last);
+        case Virama::Pamudpod:
+            return transliterate<Orthography::Traditional, Virama::Pamudpod>(in, sink, last);
+        }
         break;
-    case 'e':
-    case 'i':
-        out += "ᜁ";
+    case Orthography::Reformed:
+        switch (style) {
+        case Virama::Krus:
+            return transliterate<Orthography::Reformed, Virama::Krus>(in, sink, last);
+        case Virama::Pamudpod:
+            return transliterate<Orthography::Reformed, Virama::Pamudpod>(in, sink, last);
+        }
         break;
-    case 'o':
-    case 'u':
-        out += "ᜂ";
+    case Orthography::Modern:
+        switch (style) {
+        case Virama::Krus:
+            return transliterate<Orthography::Modern, Virama::Krus>(in, sink, last);
+        case Virama::Pamudpod:
+            return transliterate<Orthography::Modern, Virama::Pamudpod>(in, sink, last);
+        }
         break;
     }
+    return 0;
 }
 
-inline void
-emit_consonant(std::string &out, char c, Orthography ortho) {
-    switch (c) {
-    case 'b':
-        out += "ᜊ";
-        break;
-    case 'k':
-        out += "ᜃ";
-        break;
-    case 'r': // r and d are allophones of the same phoneme
-    case 'd':
-        out += "ᜇ";
-        break;
-    case 'g':
-        out += "ᜄ";
-        break;
-    case 'h':
-        out += "ᜑ";
-        break;
-    case 'l':
-        out += "ᜎ";
-        break;
-    case 'm':
-        out += "ᜋ";
-        break;
-    case 'n':
-        out += "ᜈ";
-        break;
-    case 'p':
-        out += "ᜉ";
-        break;
-    case 's':
-        out += "ᜐ";
-        break;
-    case 't':
-        out += "ᜆ";
-        break;
-    case 'w':
-        out += "ᜏ";
-        break;
-    case 'y':
-        out += "ᜌ";
-        break;
+/**
+ * @name latin_to_baybayin
+ * @brief Appends the transliteration of in to out. Reusing out across calls avoids allocating once it has grown.
+ */
+template<CharString TString>
+void
+latin_to_baybayin(const std::string_view in, TString &out, const Orthography ortho = Orthography::Reformed,
+                  const Virama style = Virama::Krus
+) {
+    StringSink sink(out);
+    transliterate(in, sink, ortho, style);
+    sink.finish();
+}
+
+/**
+ * @name latin_to_baybayin
+ * @brief Appends the transliteration of in to out, as above, looking each word and the whitespace and punctuation
+ * after it up in cache first. A glyph depends on at most the two bytes after it and letters never on a byte past
+ * the next separator, so a word transliterates the same alone as in its text. Words are keyed lowercased, as the
+ * core reads them.
+ */
+template<CharString TString>
+void
+latin_to_baybayin(const std::string_view in, TString &out, WordCache &cache,
+                  const Orthography ortho = Orthography::Reformed, const Virama style = Virama::Krus
+) {
+    if (cache.bypass(in.size())) {
+        latin_to_baybayin(in, out, ortho, style);
+        return;
+    }
+    const auto tag = CacheTransliterate | static_cast<uint32_t>(ortho) << 1 | static_cast<uint32_t>(style);
+    std::array<char, WordCache::SlotBytes> key;
+    TString miss(out.get_allocator());
+    StringWriter writer(out);
+    for (const auto &[word, size] : Words(in)) {
+        uint64_t hash = 0;
+        if (word.size() <= key.size()) {
+            std::ranges::transform(word, key.begin(), ascii_lower);
+            hash = WordCache::hash(tag, {key.data(), word.size()});
+            if (const auto *entry = cache.find(hash, tag, {key.data(), word.size()})) {
+                writer.reserve(WordCache::SlotBytes);
+                writer.template append_block<WordCache::SlotBytes>(entry->bytes.data(), entry->value_size);
+                continue;
+            }
+        }
+        miss.clear();
+        latin_to_baybayin(word, miss, ortho, style);
+        if (word.size() <= key.size()) {
+            cache.insert(hash, tag, {key.data(), word.size()}, miss);
+        }
+        writer.reserve(miss.size());
+        writer.append(miss);
     }
+    writer.finish();
 }
 
+/**
+ * @name latin_to_baybayin
+ * @brief Writes the transliteration of in to out, which should hold baybayin_output_size(in, ortho, style) bytes.
+ * @return The number of bytes written. Output stops at the last glyph that fits, so a smaller result than
+ * baybayin_output_size means out was too small.
+ */
+inline size_t
+latin_to_baybayin(const std::string_view in, const std::span<char> out,
+                  const Orthography ortho = Orthography::Reformed, const Virama style = Virama::Krus
+) {
+    SpanSink sink(out);
+    transliterate(in, sink, ortho, style);
+    return sink.cursor() - out.data();
+}
+
+/**
+ * @name latin_to_baybayin
+ * @brief Transliterates normalized Latin text.
+ * @param in Normalized Latin input
+ * @param ortho Output orthography
+ * @param style Virama used for codas
+ * @return Baybayin UTF-8 text
+ */
 inline std::string
 latin_to_baybayin(const std::string_view in, const Orthography ortho = Orthography::Reformed,
                   const Virama style = Virama::Krus
 ) {
     std::string out;
     out.reserve(in.size() * 3);
-    const size_t n = in.size();
+    latin_to_baybayin(in, out, ortho, style);
+    return out;
+}
+
+/**
+ * @name latin_to_baybayin
+ * @brief Transliterates normalized Latin text into a string allocated from resource.
+ */
+inline std::pmr::string
+latin_to_baybayin(const std::string_view in, std::pmr::memory_resource *resource,
+                  const Orthography ortho = Orthography::Reformed, const Virama style = Virama::Krus
+) {
+    std::pmr::string out(resource);
+    out.reserve(in.size() * 3);
+    latin_to_baybayin(in, out, ortho, style);
+    return out;
+}
+
+/**
+ * @name latin_to_baybayin
+ * @brief Appends the transliteration of in to out, specialized at compile time.
+ */
+template<Orthography TOrtho, Virama TStyle = Virama::Krus, CharString TString>
+void
+latin_to_baybayin(const std::string_view in, TString &out) {
+    StringSink sink(out);
+    transliterate<TOrtho, TStyle>(in, sink);
+    sink.finish();
+}
+
+/**
+ * @name latin_to_baybayin
+ * @brief Transliterates normalized Latin text, specialized at compile time.
+ */
+template<Orthography TOrtho, Virama TStyle = Virama::Krus>
+std::string
+latin_to_baybayin(const std::string_view in) {
+    std::string out;
+    out.reserve(in.size() * 3);
+    latin_to_baybayin<TOrtho, TStyle>(in, out);
+    return out;
+}
+
+/**
+ * @name latin_to_baybayin_batch
+ * @brief Transliterates every input into batch, replacing its contents. The arena is sized for the whole column up
+ * front, so a fresh Batch normally costs two allocations and a reused one none.
+ */
+inline void
+latin_to_baybayin_batch(const std::span<const std::string_view> inputs, Batch &batch,
+                        const Orthography ortho = Orthography::Reformed, const Virama style = Virama::Krus
+) {
+    batch.clear();
+    batch.offsets.reserve(inputs.size() + 1);
+    batch.data.reserve(total_size(inputs) * 3);
+    batch.offsets.push_back(0);
+    StringSink sink(batch.data);
+    for (const auto &input : inputs) {
+        transliterate(input, sink, ortho, style);
+        batch.offsets.push_back(sink.size());
+    }
+    sink.finish();
+}
+
+/**
+ * @name latin_to_baybayin_batch
+ * @brief Transliterates a column of short strings into one arena.
+ */
+inline Batch
+latin_to_baybayin_batch(const std::span<const std::string_view> inputs,
+                        const Orthography ortho = Orthography::Reformed, const Virama style = Virama::Krus
+) {
+    Batch batch;
+    latin_to_baybayin_batch(inputs, batch, ortho, style);
+    return batch;
+}
+
+/**
+ * @name baybayin_output_size
+ * @brief The exact number of bytes latin_to_baybayin produces for in.
+ */
+inline size_t
+baybayin_output_size(const std::string_view in, const Orthography ortho = Orthography::Reformed,
+                     const Virama style = Virama::Krus
+) {
+    CountingSink sink;
+    transliterate(in, sink, ortho, style);
+    return sink.size();
+}
+
+/**
+ * @name StreamingTransliterator
+ * @brief Transliterates text that arrives in arbitrary chunks. A consonant at the end of a chunk is held back with
+ * the byte after it until the vowel or NG digraph that follows is known, so at most two bytes are carried between
+ * calls. The concatenated output of feed() and finish() equals latin_to_baybayin of the concatenated chunks.
+ */
+class StreamingTransliterator {
+    Orthography ortho_;
+    Virama style_;
+    std::array<char, 4> pending_{};
+    size_t pending_size_ = 0;
+
+public:
+    explicit StreamingTransliterator(const Orthography ortho = Orthography::Reformed,
+                                     const Virama style = Virama::Krus
+    ) : ortho_(ortho), style_(style) {
+    }
 
-    auto apply_virama = [&](char c, size_t pos) {
-        if (ortho != Orthography::Traditional) {
-            emit_consonant(out, c, ortho);
-            out += (style == Virama::Pamudpod ? "᜴" : "᜔");
+    /**
+     * @name feed
+     * @brief Appends the output for the next chunk of input to out.
+     */
+    template<CharString TString>
+    void
+    feed(std::string_view chunk, TString &out) {
+        StringSink sink(out);
+        if (pending_size_ > 0) {
+            // complete the held back syllable with the first bytes of the chunk
+            const size_t joined = std::min(chunk.size(), pending_.size() - pending_size_);
+            std::copy_n(chunk.data(), joined, pending_.data() + pending_size_);
+            const size_t consumed = transliterate(std::string_view(pending_.data(), pending_size_ + joined), sink,
+                                                  ortho_, style_, false);
+            if (consumed < pending_size_) {
+                // still short of lookahead, which means the whole chunk fit in pending_
+                std::copy(pending_.data() + consumed, pending_.data() + pending_size_ + joined, pending_.data());
+                pending_size_ = pending_size_ + joined - consumed;
+                sink.finish();
+                return;
+            }
+            chunk.remove_prefix(consumed - pending_size_);
+            pending_size_ = 0;
         }
-    };
+        const size_t consumed = transliterate(chunk, sink, ortho_, style_, false);
+        pending_size_ = chunk.size() - consumed;
+        std::copy_n(chunk.data() + consumed, pending_size_, pending_.data());
+        sink.finish();
+    }
 
-    for (size_t i = 0; i < n; ++i) {
-        char c = ascii_lower(in[i]);
-
-        // --- NG Digraph ---
-        if (c == 'n' && i + 1 < n && ascii_lower(in[i + 1]) == 'g') {
-            if (const size_t ng_pos = i + 1;
-                ng_pos + 1 < n) {
-                if (is_vowel(ascii_lower(in[ng_pos + 1]))) {
-                    out += "ᜅ";
-                    if (const char v = ascii_lower(in[ng_pos + 1]);
-                        v == 'i' || v == 'e')
-                        out += "ᜒ";
-                    else if (v == 'o' || v == 'u')
-                        out += "ᜓ";
-                    i += 2; // Skip 'g' and vowel
-                }
-            } else {
-                // It's a trailing NG
-                if (ortho == Orthography::Modern || (
-                        ortho == Orthography::Reformed && (ng_pos == n - 1 || std::isspace(in[ng_pos + 1])))) {
-                    out += "ᜅ";
-                    out += (style == Virama::Pamudpod ? "᜴" : "᜔");
+    /**
+     * @name finish
+     * @brief Appends the output for the bytes held back to out, ending the text. The transliterator can be reused.
+     */
+    template<CharString TString>
+    void
+    finish(TString &out) {
+        StringSink sink(out);
+        transliterate(std::string_view(pending_.data(), pending_size_), sink, ortho_, style_);
+        pending_size_ = 0;
+        sink.finish();
+    }
+};
+
+/**
+ * @name baybayin_to_latin
+ * @brief Appends the Latin reading of Baybayin text to out. Characters of the Tagalog block are three UTF-8 bytes,
+ * E1 9C xx, and decoded with a single lookup of xx in BaybayinClasses. A consonant keeps its inherent 'a' unless a
+ * kudlit or a virama follows. | and || become a comma and a period, everything else is copied as is.
+ * Allophones are read as d, i and u.
+ */
+template<CharString TString>
+void
+baybayin_to_latin(const std::string_view in, TString &out) {
+    out.reserve(out.size() + in.size());
+    const size_t n = in.size();
+    bool inherent = false; // the last consonant still owes its 'a'
+    const auto flush = [&] {
+        if (inherent) {
+            out.push_back('a');
+            inherent = false;
+        }
+    };
+    for (size_t i = 0; i < n;) {
+        if (in[i] == '\xE1' && i + 2 < n && in[i + 1] == '\x9C') {
+            const auto &[kind, latin, size] = BaybayinClasses[static_cast<unsigned char>(in[i + 2]) & 0x3F];
+            switch (kind) {
+            case BaybayinKind::Consonant:
+                flush();
+                out.append(latin.data(), size);
+                inherent = true;
+                break;
+            case BaybayinKind::Kudlit:
+                if (inherent) {
+                    out.append(latin.data(), size);
+                    inherent = false;
                 }
-                i += 1; // Skip 'g'
+                break;
+            case BaybayinKind::Virama:
+                inherent = false;
+                break;
+            case BaybayinKind::Vowel:
+            case BaybayinKind::Punctuation:
+                flush();
+                out.append(latin.data(), size);
+                break;
+            case BaybayinKind::Unknown:
+                flush();
+                out.append(in.data() + i, 3);
+                break;
             }
+            i += 3;
             continue;
         }
-
-        // --- Standalone Vowel ---
-        if (is_vowel(c)) {
-            emit_vowel(out, c);
+        flush();
+        if (in[i] == '|') {
+            const bool stop = i + 1 < n && in[i + 1] == '|';
+            out.push_back(stop ? '.' : ',');
+            i += stop ? 2 : 1;
             continue;
         }
-
-        // --- Consonant Cluster / Coda ---
-        switch (c) {
-        case 'b':
-        case 'k':
-        case 'd':
-        case 'g':
-        case 'h':
-        case 'l':
-        case 'm':
-        case 'n':
-        case 'p':
-        case 'r':
-        case 's':
-        case 't':
-        case 'w':
-        case 'y':
-            if (i + 1 < n && is_vowel(ascii_lower(in[i + 1]))) {
-                emit_consonant(out, c, ortho);
-                char v = ascii_lower(in[i + 1]);
-                if (v == 'i' || v == 'e')
-                    out += "ᜒ";
-                else if (v == 'o' || v == 'u')
-                    out += "ᜓ";
-                ++i;
-            } else {
-                apply_virama(c, i);
-            }
-            break;
-        case ' ':
-            if (ortho != Orthography::Traditional) {
-                out += ' ';
-            }
-            break;
-        case ',':
-            out += '|';
-            break;
-        case '.':
-        case '!':
-        case '?':
-            out += "||";
-            break;
-        default:
-            break;
-            //out += in[i]; // Non-alphabetic
-        }
+        out.push_back(in[i++]);
     }
+    flush();
+}
+
+/**
+ * @name baybayin_to_latin
+ * @brief Reads Baybayin text back into Latin.
+ * @param in Baybayin UTF-8 text
+ * @return Latin text
+ */
+inline std::string
+baybayin_to_latin(const std::string_view in) {
+    std::string out;
+    baybayin_to_latin(in, out);
     return out;
 }
 
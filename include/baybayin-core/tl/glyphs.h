@@ -0,0 +1,245 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace baybayin {
+
+enum class Orthography {
+    // NOTES: https://luffykudo.wordpress.com/2020/08/10/how-to-read-and-write-baybayin/
+    Traditional, // Pre-colonial: no ending consonants for syllables (or words)
+    Reformed,    // Added ending consonants for syllables (and words), adds word spacing, | as comma,
+    Modern       // Suggestions (added additional sounds:  f, j, v, z ??
+};
+
+enum class Virama {
+    Krus,    // Standard Spanish "+"
+    Pamudpod // Modern curved slash style "᜴ "
+};
+
+// Index of a base character in the syllable table. None is the carrier of a standalone vowel.
+enum class Consonant : uint8_t { None, B, K, D, R, G, H, L, M, N, P, S, T, W, Y, NG };
+
+// The vowel following a consonant, e/i and o/u being allophones. None means the consonant is a coda.
+enum class VowelClass : uint8_t { None, A, I, U };
+
+enum class Punctuation : uint8_t { None, Space, Comma, Stop };
+
+inline constexpr size_t OrthographyCount = 3;
+inline constexpr size_t ViramaCount = 2;
+inline constexpr size_t ConsonantCount = 16;
+inline constexpr size_t VowelClassCount = 4;
+inline constexpr size_t PunctuationCount = 4;
+
+/**
+ * @name Glyph
+ * @brief Pre-encoded UTF-8 for one syllable: a base character plus at most one diacritic (kudlit or virama).
+ */
+struct Glyph {
+    std::array<char, 6> bytes{};
+    uint8_t size = 0;
+
+    [[nodiscard]] constexpr std::string_view
+    view() const noexcept {
+        return {bytes.data(), size};
+    }
+};
+
+constexpr void
+append_utf8(Glyph &glyph, const char32_t cp) {
+    if (cp < 0x80) {
+        glyph.bytes[glyph.size++] = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        glyph.bytes[glyph.size++] = static_cast<char>(0xC0 | (cp >> 6));
+        glyph.bytes[glyph.size++] = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        glyph.bytes[glyph.size++] = static_cast<char>(0xE0 | (cp >> 12));
+        glyph.bytes[glyph.size++] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        glyph.bytes[glyph.size++] = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// Base characters per orthography, indexed by Consonant. A new glyph for an orthography (e.g. ᜍ U+170D for r
+// in Modern) is a change to its row only.
+inline constexpr std::array<std::array<char32_t, ConsonantCount>, OrthographyCount> BaseCharacters = {{
+    // -, b, k, d, r (allophone of d), g, h, l, m, n, p, s, t, w, y, ng
+    {0, U'ᜊ', U'ᜃ', U'ᜇ', U'ᜇ', U'ᜄ', U'ᜑ', U'ᜎ', U'ᜋ', U'ᜈ', U'ᜉ', U'ᜐ', U'ᜆ', U'ᜏ', U'ᜌ', U'ᜅ'}, // Traditional
+    {0, U'ᜊ', U'ᜃ', U'ᜇ', U'ᜇ', U'ᜄ', U'ᜑ', U'ᜎ', U'ᜋ', U'ᜈ', U'ᜉ', U'ᜐ', U'ᜆ', U'ᜏ', U'ᜌ', U'ᜅ'}, // Reformed
+    {0, U'ᜊ', U'ᜃ', U'ᜇ', U'ᜇ', U'ᜄ', U'ᜑ', U'ᜎ', U'ᜋ', U'ᜈ', U'ᜉ', U'ᜐ', U'ᜆ', U'ᜏ', U'ᜌ', U'ᜅ'}, // Modern
+}};
+
+// Standalone vowels, indexed by VowelClass
+inline constexpr std::array<char32_t, VowelClassCount> VowelCharacters = {0, U'ᜀ', U'ᜁ', U'ᜂ'};
+
+// Kudlit (vowel marks), indexed by VowelClass. The inherent vowel is 'a' so it has no mark.
+inline constexpr std::array<char32_t, VowelClassCount> KudlitCharacters = {0, 0, U'ᜒ', U'ᜓ'};
+
+// Vowel killers, indexed by Virama
+inline constexpr std::array<char32_t, ViramaCount> ViramaCharacters = {U'᜔', U'᜴'};
+
+using SyllableGlyphs = std::array<std::array<Glyph, VowelClassCount>, ConsonantCount>;
+
+constexpr SyllableGlyphs
+make_syllable_glyphs(const Orthography ortho, const Virama style) {
+    SyllableGlyphs table{};
+    const auto &bases = BaseCharacters[static_cast<size_t>(ortho)];
+    for (size_t v = 1; v < VowelClassCount; ++v) {
+        append_utf8(table[0][v], VowelCharacters[v]);
+    }
+    for (size_t c = 1; c < ConsonantCount; ++c) {
+        for (size_t v = 1; v < VowelClassCount; ++v) {
+            append_utf8(table[c][v], bases[c]);
+            if (KudlitCharacters[v]) {
+                append_utf8(table[c][v], KudlitCharacters[v]);
+            }
+        }
+        // Traditional has no codas, the consonant is dropped
+        if (ortho != Orthography::Traditional) {
+            append_utf8(table[c][0], bases[c]);
+            append_utf8(table[c][0], ViramaCharacters[static_cast<size_t>(style)]);
+        }
+    }
+    return table;
+}
+
+constexpr auto
+make_syllable_table() {
+    std::array<std::array<SyllableGlyphs, ViramaCount>, OrthographyCount> table{};
+    for (size_t o = 0; o < OrthographyCount; ++o) {
+        for (size_t s = 0; s < ViramaCount; ++s) {
+            table[o][s] = make_syllable_glyphs(static_cast<Orthography>(o), static_cast<Virama>(s));
+        }
+    }
+    return table;
+}
+
+// Indexed by [Orthography][Virama][Consonant][VowelClass]
+inline constexpr auto SyllableTable = make_syllable_table();
+
+constexpr auto
+make_punctuation_table() {
+    std::array<std::array<Glyph, PunctuationCount>, OrthographyCount> table{};
+    for (size_t o = 0; o < OrthographyCount; ++o) {
+        // word spacing was added with the reformed orthography
+        if (static_cast<Orthography>(o) != Orthography::Traditional) {
+            append_utf8(table[o][static_cast<size_t>(Punctuation::Space)], U' ');
+        }
+        append_utf8(table[o][static_cast<size_t>(Punctuation::Comma)], U'|');
+        append_utf8(table[o][static_cast<size_t>(Punctuation::Stop)], U'|');
+        append_utf8(table[o][static_cast<size_t>(Punctuation::Stop)], U'|');
+    }
+    return table;
+}
+
+// Indexed by [Orthography][Punctuation]
+inline constexpr auto PunctuationTable = make_punctuation_table();
+
+enum class LatinKind : uint8_t { Ignored, Vowel, Consonant, Punctuation };
+
+/**
+ * @name LatinClass
+ * @brief Classification of an input byte. index is a VowelClass, Consonant or Punctuation depending on kind.
+ */
+struct LatinClass {
+    LatinKind kind = LatinKind::Ignored;
+    uint8_t index = 0;
+};
+
+constexpr auto
+make_latin_classes() {
+    std::array<LatinClass, 256> table{};
+    constexpr auto vowel = [](const VowelClass v) {
+        return LatinClass{LatinKind::Vowel, static_cast<uint8_t>(v)};
+    };
+    constexpr auto consonant = [](const Consonant c) {
+        return LatinClass{LatinKind::Consonant, static_cast<uint8_t>(c)};
+    };
+    constexpr std::array<std::pair<char, LatinClass>, 19> letters = {{
+        {'a', vowel(VowelClass::A)},        {'e', vowel(VowelClass::I)},        {'i', vowel(VowelClass::I)},
+        {'o', vowel(VowelClass::U)},        {'u', vowel(VowelClass::U)},        {'b', consonant(Consonant::B)},
+        {'k', consonant(Consonant::K)},     {'d', consonant(Consonant::D)},     {'r', consonant(Consonant::R)},
+        {'g', consonant(Consonant::G)},     {'h', consonant(Consonant::H)},     {'l', consonant(Consonant::L)},
+        {'m', consonant(Consonant::M)},     {'n', consonant(Consonant::N)},     {'p', consonant(Consonant::P)},
+        {'s', consonant(Consonant::S)},     {'t', consonant(Consonant::T)},     {'w', consonant(Consonant::W)},
+        {'y', consonant(Consonant::Y)},
+    }};
+    for (const auto &[letter, cls] : letters) {
+        table[static_cast<unsigned char>(letter)] = cls;
+        table[static_cast<unsigned char>(letter - 'a' + 'A')] = cls;
+    }
+    constexpr auto punctuation = [](const Punctuation p) {
+        return LatinClass{LatinKind::Punctuation, static_cast<uint8_t>(p)};
+    };
+    table[' '] = punctuation(Punctuation::Space);
+    table[','] = punctuation(Punctuation::Comma);
+    table['.'] = punctuation(Punctuation::Stop);
+    table['!'] = punctuation(Punctuation::Stop);
+    table['?'] = punctuation(Punctuation::Stop);
+    return table;
+}
+
+// Indexed by input byte
+inline constexpr auto LatinClasses = make_latin_classes();
+
+enum class BaybayinKind : uint8_t { Unknown, Consonant, Vowel, Kudlit, Virama, Punctuation };
+
+/**
+ * @name BaybayinClass
+ * @brief Decoding of a character of the Tagalog (U+1700-U+171F) and Hanunoo (U+1720-U+173F) blocks, all of which
+ * are encoded as E1 9C xx in UTF-8. latin holds the consonant, the vowel or the punctuation to write.
+ */
+struct BaybayinClass {
+    BaybayinKind kind = BaybayinKind::Unknown;
+    std::array<char, 2> latin{};
+    uint8_t size = 0;
+};
+
+inline constexpr char32_t BaybayinBlockStart = 0x1700;
+inline constexpr size_t BaybayinBlockSize = 0x40;
+
+// Latin spelling of each Consonant, d taking precedence over its allophone r when decoding
+inline constexpr std::array<std::string_view, ConsonantCount> ConsonantLetters = {
+"", "b", "k", "d", "r", "g", "h", "l", "m", "n", "p", "s", "t", "w", "y", "ng"};
+
+constexpr auto
+make_baybayin_classes() {
+    std::array<BaybayinClass, BaybayinBlockSize> table{};
+    const auto set = [&table](const char32_t cp, const BaybayinKind kind, const std::string_view latin) {
+        auto &entry = table[cp - BaybayinBlockStart];
+        if (entry.kind == BaybayinKind::Unknown) {
+            entry.kind = kind;
+            for (const char c : latin) {
+                entry.latin[entry.size++] = c;
+            }
+        }
+    };
+    for (const auto &bases : BaseCharacters) {
+        for (size_t c = 1; c < ConsonantCount; ++c) {
+            set(bases[c], BaybayinKind::Consonant, ConsonantLetters[c]);
+        }
+    }
+    set(U'ᜍ', BaybayinKind::Consonant, "r"); // ra, U+170D
+    set(U'ᜟ', BaybayinKind::Consonant, "r"); // archaic ra, U+171F
+    constexpr std::array<std::string_view, VowelClassCount> vowels = {"", "a", "i", "u"};
+    for (size_t v = 1; v < VowelClassCount; ++v) {
+        set(VowelCharacters[v], BaybayinKind::Vowel, vowels[v]);
+        if (KudlitCharacters[v]) {
+            set(KudlitCharacters[v], BaybayinKind::Kudlit, vowels[v]);
+        }
+    }
+    for (const char32_t virama : ViramaCharacters) {
+        set(virama, BaybayinKind::Virama, "");
+    }
+    set(U'᜕', BaybayinKind::Virama, "");      // tagalog pamudpod, U+1715
+    set(U'᜵', BaybayinKind::Punctuation, ","); // philippine single punctuation, U+1735
+    set(U'᜶', BaybayinKind::Punctuation, "."); // philippine double punctuation, U+1736
+    return table;
+}
+
+// Indexed by code point - BaybayinBlockStart, which is the last UTF-8 byte - 0x80
+inline constexpr auto BaybayinClasses = make_baybayin_classes();
+
+} // namespace baybayin
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <baybayin-core/tl/glyphs.h>
+#include <baybayin-core/util/writer.h>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string>
+
+namespace baybayin {
+
+// Output targets for the transliteration core. reserve(bytes) is called before each block of glyphs with an upper
+// bound of what the block can emit, emit(glyph) once per glyph.
+
+/**
+ * @name StringSink
+ * @brief Appends to a caller-owned string, keeping whatever it already holds. The string is grown a block at a
+ * time by a StringWriter so glyphs are copied as whole Glyph buffers; finish() trims it back to the bytes written.
+ */
+template<CharString TString = std::string>
+class StringSink {
+    StringWriter<TString> writer_;
+
+public:
+    explicit StringSink(TString &out) : writer_(out) {
+    }
+
+    [[gnu::always_inline]] void
+    reserve(const size_t bytes) {
+        writer_.reserve(bytes);
+    }
+
+    void
+    emit(const Glyph &glyph) noexcept {
+        writer_.template append_block<sizeof(Glyph::bytes)>(glyph.bytes.data(), glyph.size);
+    }
+
+    [[nodiscard]] size_t
+    size() const noexcept {
+        return writer_.size();
+    }
+
+    void
+    finish() {
+        writer_.finish();
+    }
+};
+
+/**
+ * @name SpanSink
+ * @brief Writes into a caller-owned buffer. Glyphs that do not fit are dropped whole and mark the sink overflowed.
+ */
+class SpanSink {
+    char *cursor_;
+    char *const end_;
+    bool overflow_ = false;
+
+public:
+    explicit SpanSink(const std::span<char> out) noexcept : cursor_(out.data()), end_(out.data() + out.size()) {
+    }
+
+    void
+    reserve(size_t) noexcept {
+    }
+
+    void
+    emit(const Glyph &glyph) noexcept {
+        if (const auto room = static_cast<size_t>(end_ - cursor_);
+            room >= sizeof(glyph.bytes)) {
+            std::memcpy(cursor_, glyph.bytes.data(), sizeof(glyph.bytes));
+        } else if (!overflow_ && room >= glyph.size) {
+            std::memcpy(cursor_, glyph.bytes.data(), glyph.size);
+        } else {
+            overflow_ = true;
+            return;
+        }
+        cursor_ += glyph.size;
+    }
+
+    [[nodiscard]] char *
+    cursor() const noexcept {
+        return cursor_;
+    }
+
+    [[nodiscard]] bool
+    overflow() const noexcept {
+        return overflow_;
+    }
+};
+
+/**
+ * @name CountingSink
+ * @brief Counts the bytes that would be written.
+ */
+class CountingSink {
+    size_t size_ = 0;
+
+public:
+    void
+    reserve(size_t) noexcept {
+    }
+
+    void
+    emit(const Glyph &glyph) noexcept {
+        size_ += glyph.size;
+    }
+
+    [[nodiscard]] size_t
+    size() const noexcept {
+        return size_;
+    }
+};
+
+} // namespace baybayin
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace baybayin {
+
+/**
+ * @name Batch
+ * @brief The results of a batch call packed into one buffer, Arrow style: result i is
+ * data[offsets[i], offsets[i + 1]). A Batch passed back into a batch call is cleared and reuses its storage, its
+ * scratch buffers included.
+ */
+struct Batch {
+    std::string data;
+    std::vector<size_t> offsets;
+    // What the normalizer works in between its passes and folds its input into, kept across calls
+    std::string stage;
+    std::string folded;
+
+    [[nodiscard]] size_t
+    size() const noexcept {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+
+    [[nodiscard]] std::string_view
+    operator[](const size_t i) const noexcept {
+        return std::string_view(data).substr(offsets[i], offsets[i + 1] - offsets[i]);
+    }
+
+    void
+    clear() noexcept {
+        data.clear();
+        offsets.clear();
+    }
+};
+
+inline size_t
+total_size(const std::span<const std::string_view> inputs) noexcept {
+    size_t total = 0;
+    for (const auto &input : inputs) {
+        total += input.size();
+    }
+    return total;
+}
+
+} // namespace baybayin
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+// Memoized results for single words. Natural text is dominated by a few hundred words, so an engine that only needs
+// a word to know its output can look the word up instead of recomputing it. The cache is not synchronized: each
+// thread, or each worker of a LinePool, owns one.
+
+namespace baybayin {
+
+// Tag bits naming the engine a cached result is for, so engines can share a cache; the rest of a tag is the
+// engine's configuration
+enum WordCacheTag : uint32_t {
+    CacheTransliterate = 1u << 24,
+    CacheNormalize = 2u << 24,
+    CachePipeline = 3u << 24,
+    CacheLexicon = 1u << 30, // the engine has a lexicon, a cache is only shared between engines with the same one
+    CacheLastWord = 1u << 31, // the word ends the text
+};
+
+/**
+ * @name WordCache
+ * @brief A bounded open-addressing hash table from a word and an engine configuration to the engine's output for
+ * it. Keys and values live inline in fixed 128 byte slots, so a lookup touches two cache lines and filling the
+ * table allocates nothing. Words whose key and value do not fit in a slot are simply not cached. Once every slot
+ * of a probe window is taken, a new word replaces the one in its home slot.
+ *
+ * Running an engine a word at a time costs about twice as much as running it over a whole text, so a cache only
+ * pays for itself on text that hits it most of the time. After every window of lookups that mostly missed, the
+ * cache asks engines to bypass it for a stretch of input, then measures again.
+ */
+class WordCache {
+public:
+    // Key and value bytes stored in one slot
+    static constexpr size_t SlotBytes = 113;
+
+    /**
+     * @name Entry
+     * @brief A cached result: the value bytes, then the key, and a few flag bits the engine stores with them. The
+     * value comes first so it can be copied out as a whole fixed-size block.
+     */
+    struct alignas(64) Entry {
+        uint64_t hash = 0; // 0 marks an empty slot
+        uint32_t tag = 0;
+        uint8_t key_size = 0;
+        uint8_t value_size = 0;
+        uint8_t flags = 0;
+        std::array<char, SlotBytes> bytes;
+
+        [[nodiscard]] std::string_view
+        value() const noexcept {
+            return {bytes.data(), value_size};
+        }
+
+        [[nodiscard]] std::string_view
+        key() const noexcept {
+            return {bytes.data() + value_size, key_size};
+        }
+    };
+
+private:
+    static constexpr size_t ProbeLength = 4;
+    // Lookups per measurement, the hits out of them that keep the cache on, and the input bytes bypassed otherwise
+    static constexpr uint32_t Window = 1024;
+    static constexpr uint32_t WindowHits = Window * 7 / 8;
+    static constexpr size_t BypassBytes = 1 << 20;
+
+    std::vector<Entry> slots_;
+    size_t mask_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint32_t window_lookups_ = 0;
+    uint32_t window_hits_ = 0;
+    size_t bypass_ = 0;
+
+    void
+    measure(const bool hit) noexcept {
+        window_hits_ += hit ? 1 : 0;
+        if (++window_lookups_ == Window) {
+            bypass_ = window_hits_ < WindowHits ? BypassBytes : 0;
+            window_lookups_ = 0;
+            window_hits_ = 0;
+        }
+    }
+
+public:
+    /**
+     * @param entries Rounded up to a power of two, 0 makes a cache that stores nothing
+     */
+    explicit WordCache(const size_t entries) : slots_(entries == 0 ? 0 : std::bit_ceil(entries)),
+                                               mask_(slots_.empty() ? 0 : slots_.size() - 1) {
+    }
+
+    /**
+     * @name bypass
+     * @brief Whether an engine should skip the cache for an input of size bytes, because the cache is off or has
+     * been missing. Counts the bytes against the stretch being bypassed.
+     */
+    [[nodiscard]] bool
+    bypass(const size_t size) noexcept {
+        if (slots_.empty()) {
+            return true;
+        }
+        if (bypass_ == 0) {
+            return false;
+        }
+        bypass_ -= std::min(bypass_, size);
+        return true;
+    }
+
+    /**
+     * @name hash
+     * @brief Hashes a word together with the tag of the configuration it was computed for, eight bytes at a time.
+     */
+    [[nodiscard]] static uint64_t
+    hash(const uint32_t tag, const std::string_view key) noexcept {
+        constexpr uint64_t multiplier = 0x9E3779B97F4A7C15;
+        uint64_t h = (uint64_t{tag} << 32 | key.size()) * multiplier;
+        size_t i = 0;
+        for (; i + 8 <= key.size(); i += 8) {
+            uint64_t word;
+            std::memcpy(&word, key.data() + i, 8);
+            h = std::rotl((h ^ word) * multiplier, 29);
+        }
+        uint64_t rest = 0;
+        for (size_t shift = 0; i < key.size(); ++i, shift += 8) {
+            rest |= uint64_t{static_cast<unsigned char>(key[i])} << shift;
+        }
+        h = (h ^ rest) * multiplier;
+        return (h ^ h >> 32) | 1;
+    }
+
+    /**
+     * @name find
+     * @brief Looks a word up, counting a hit or a miss.
+     * @param hash hash(tag, key)
+     * @return The entry, valid until the next insert, or nullptr
+     */
+    [[nodiscard]] const Entry *
+    find(const uint64_t hash, const uint32_t tag, const std::string_view key) noexcept {
+        for (size_t p = 0; p < ProbeLength && !slots_.empty(); ++p) {
+            const Entry &entry = slots_[(hash + p) & mask_];
+            if (entry.hash == 0) {
+                break; // slots are never emptied, so the word is not further on
+            }
+            if (entry.hash == hash && entry.tag == tag && entry.key() == key) {
+                ++hits_;
+                measure(true);
+                return &entry;
+            }
+        }
+        ++misses_;
+        measure(false);
+        return nullptr;
+    }
+
+    /**
+     * @name insert
+     * @brief Stores the result for a word that find missed, if it fits in a slot.
+     */
+    void
+    insert(const uint64_t hash, const uint32_t tag, const std::string_view key, const std::string_view value,
+           const uint8_t flags = 0
+    ) noexcept {
+        if (slots_.empty() || key.size() + value.size() > SlotBytes) {
+            return;
+        }
+        Entry *entry = &slots_[hash & mask_];
+        for (size_t p = 0; p < ProbeLength; ++p) {
+            if (Entry &candidate = slots_[(hash + p) & mask_];
+                candidate.hash == 0) {
+                entry = &candidate;
+                break;
+            }
+        }
+        entry->hash = hash;
+        entry->tag = tag;
+        entry->key_size = static_cast<uint8_t>(key.size());
+        entry->value_size = static_cast<uint8_t>(value.size());
+        entry->flags = flags;
+        std::memcpy(entry->bytes.data(), value.data(), value.size());
+        std::memcpy(entry->bytes.data() + value.size(), key.data(), key.size());
+    }
+
+    // Slots in the table, 0 when caching is off
+    [[nodiscard]] size_t
+    capacity() const noexcept {
+        return slots_.size();
+    }
+
+    [[nodiscard]] uint64_t
+    hits() const noexcept {
+        return hits_;
+    }
+
+    [[nodiscard]] uint64_t
+    misses() const noexcept {
+        return misses_;
+    }
+};
+
+} // namespace baybayin
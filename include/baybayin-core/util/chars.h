@@ -0,0 +1,207 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+
+// Byte classes shared by the normalizer and the transliterator, and the word boundaries built on them. They only
+// know ASCII and the shape of UTF-8, so they never depend on the locale.
+
+namespace baybayin {
+
+enum ByteClass : uint8_t {
+    ByteVowel = 1 << 0,            // a, e, i, o, u in either case
+    ByteConsonant = 1 << 1,        // any other ASCII letter
+    ByteDigit = 1 << 2,            // 0 to 9
+    ByteSpace = 1 << 3,            // ' ', \t, \n, \v, \f, \r (std::isspace in the "C" locale)
+    BytePunctuation = 1 << 4,      // printable ASCII that is not a letter or digit
+    ByteControl = 1 << 5,          // the rest of ASCII
+    ByteUtf8Lead = 1 << 6,         // starts a multibyte UTF-8 sequence, or cannot appear in UTF-8 at all
+    ByteUtf8Continuation = 1 << 7, // 10xxxxxx
+};
+
+inline constexpr uint8_t ByteLetter = ByteVowel | ByteConsonant;
+inline constexpr uint8_t ByteNonAscii = ByteUtf8Lead | ByteUtf8Continuation;
+// Whitespace and punctuation end words, everything else makes them up: digits and bytes outside ASCII too, which is
+// where ñ and the Baybayin script are
+inline constexpr uint8_t ByteSeparator = ByteSpace | BytePunctuation;
+
+constexpr auto
+make_byte_classes() {
+    std::array<uint8_t, 256> table{};
+    for (size_t b = 0; b < table.size(); ++b) {
+        const size_t lower = b | 0x20;
+        if (b >= 0x80) {
+            table[b] = (b & 0xC0) == 0x80 ? ByteUtf8Continuation : ByteUtf8Lead;
+        } else if (lower >= 'a' && lower <= 'z') {
+            const bool vowel = lower == 'a' || lower == 'e' || lower == 'i' || lower == 'o' || lower == 'u';
+            table[b] = vowel ? ByteVowel : ByteConsonant;
+        } else if (b >= '0' && b <= '9') {
+            table[b] = ByteDigit;
+        } else if (b == ' ' || (b >= '\t' && b <= '\r')) {
+            table[b] = ByteSpace;
+        } else if (b > ' ' && b < 0x7F) {
+            table[b] = BytePunctuation;
+        } else {
+            table[b] = ByteControl;
+        }
+    }
+    return table;
+}
+
+// Indexed by byte
+inline constexpr auto ByteClasses = make_byte_classes();
+
+constexpr uint8_t
+byte_class(const char c) noexcept {
+    return ByteClasses[static_cast<unsigned char>(c)];
+}
+
+constexpr bool
+is_ascii_space(const char c) noexcept {
+    return byte_class(c) & ByteSpace;
+}
+
+constexpr bool
+is_ascii_letter(const char c) noexcept {
+    return byte_class(c) & ByteLetter;
+}
+
+constexpr bool
+is_word_byte(const char c) noexcept {
+    return !(byte_class(c) & ByteSeparator);
+}
+
+constexpr char
+ascii_lower(const char c) noexcept {
+    return byte_class(c) & ByteLetter ? static_cast<char>(c | 0x20) : c;
+}
+
+/**
+ * @name is_word_start
+ * @brief Whether the byte at pos starts a word, the text before it ending in whitespace or punctuation.
+ */
+constexpr bool
+is_word_start(const std::string_view text, const size_t pos) noexcept {
+    return pos == 0 || !is_word_byte(text[pos - 1]);
+}
+
+/**
+ * @name is_word_end
+ * @brief Whether a word ends before pos, the text from pos on starting with whitespace or punctuation.
+ */
+constexpr bool
+is_word_end(const std::string_view text, const size_t pos) noexcept {
+    return pos >= text.size() || !is_word_byte(text[pos]);
+}
+
+/**
+ * @name Words
+ * @brief Splits text into words in place: a word is a run of bytes outside separators together with the run of
+ * separators after it, so the words of a text concatenate back to it. Separators at the very start make up a word
+ * with no bytes of its own.
+ */
+class Words {
+    std::string_view text_;
+    uint8_t separators_;
+
+public:
+    struct Word {
+        std::string_view text; // the word and its separators
+        size_t size;           // bytes before the separators
+
+        [[nodiscard]] std::string_view
+        word() const noexcept {
+            return text.substr(0, size);
+        }
+
+        [[nodiscard]] std::string_view
+        separators() const noexcept {
+            return text.substr(size);
+        }
+    };
+
+    class iterator {
+        std::string_view text_;
+        uint8_t separators_ = 0;
+        size_t start_ = 0;
+        Word word_{};
+
+        void
+        scan() noexcept {
+            size_t end = start_;
+            while (end < text_.size() && !(byte_class(text_[end]) & separators_)) {
+                ++end;
+            }
+            const size_t size = end - start_;
+            while (end < text_.size() && byte_class(text_[end]) & separators_) {
+                ++end;
+            }
+            word_ = {text_.substr(start_, end - start_), size};
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Word;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Word *;
+        using reference = const Word &;
+
+        iterator() = default;
+
+        iterator(const std::string_view text, const uint8_t separators, const size_t start) noexcept :
+            text_(text), separators_(separators), start_(start) {
+            scan();
+        }
+
+        reference
+        operator*() const noexcept {
+            return word_;
+        }
+
+        pointer
+        operator->() const noexcept {
+            return &word_;
+        }
+
+        iterator &
+        operator++() noexcept {
+            start_ += word_.text.size();
+            scan();
+            return *this;
+        }
+
+        iterator
+        operator++(int) noexcept {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool
+        operator==(const iterator &other) const noexcept {
+            return start_ == other.start_;
+        }
+    };
+
+    /**
+     * @param separators The ByteClass bits that separate words, whitespace and punctuation by default
+     */
+    explicit Words(const std::string_view text, const uint8_t separators = ByteSeparator) : text_(text),
+        separators_(separators) {
+    }
+
+    [[nodiscard]] iterator
+    begin() const noexcept {
+        return {text_, separators_, 0};
+    }
+
+    [[nodiscard]] iterator
+    end() const noexcept {
+        return {text_, separators_, text_.size()};
+    }
+};
+
+} // namespace baybayin
@@ -0,0 +1,338 @@
+#pragma once
+
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Line-by-line processing of a stream on a pool of threads. The input is read in large blocks cut at line ends, or
+// cut straight out of text already in memory, the blocks are handed to whichever worker is free, and a writer puts
+// the results back in input order. Every line is processed exactly as it would be alone, so the output is
+// byte-identical to a single-threaded run.
+
+namespace baybayin {
+
+inline constexpr size_t ParallelBlockSize = 1 << 20;
+
+/**
+ * @name read_lines
+ * @brief Reads about size bytes of whole lines into block. The partial line left at the end is kept in carry and
+ * starts the next block; a line longer than size is read whole.
+ * @return false once the input is exhausted
+ */
+inline bool
+read_lines(std::istream &istream, std::string &block, std::string &carry, const size_t size) {
+    block.swap(carry);
+    carry.clear();
+    while (istream) {
+        const size_t filled = block.size();
+        block.resize(filled + size);
+        istream.read(block.data() + filled, static_cast<std::streamsize>(size));
+        block.resize(filled + static_cast<size_t>(istream.gcount()));
+        if (const size_t eol = block.rfind('\n');
+            eol != std::string::npos && eol >= filled) {
+            carry.assign(block, eol + 1);
+            block.resize(eol + 1);
+            return true;
+        }
+    }
+    return !block.empty();
+}
+
+/**
+ * @name next_lines
+ * @brief Cuts about size bytes of whole lines off the front of text into block, as read_lines does from a stream but
+ * without copying them: block is a view into text. A line longer than size is taken whole.
+ * @return false once text is exhausted
+ */
+inline bool
+next_lines(std::string_view &text, std::string_view &block, const size_t size) {
+    if (text.empty()) {
+        return false;
+    }
+    size_t end = text.size();
+    if (size < text.size()) {
+        if (const size_t eol = text.rfind('\n', size - 1);
+            eol != std::string_view::npos) {
+            end = eol + 1;
+        } else if (const size_t long_eol = text.find('\n', size);
+                   long_eol != std::string_view::npos) {
+            end = long_eol + 1;
+        }
+    }
+    block = text.substr(0, end);
+    text.remove_prefix(end);
+    return true;
+}
+
+/**
+ * @name process_lines
+ * @brief Runs process over every line of block, each followed by a newline in out. A last line without a newline
+ * gets one, as with std::getline.
+ */
+template<typename TProcess>
+void
+process_lines(const std::string_view block, std::string &out, TProcess &process) {
+    for (size_t start = 0; start < block.size();) {
+        size_t end = block.find('\n', start);
+        if (end == std::string_view::npos) {
+            end = block.size();
+        }
+        process(block.substr(start, end - start), out);
+        out.push_back('\n');
+        start = end + 1;
+    }
+}
+
+/**
+ * @name OrderedBlocks
+ * @brief The blocks in flight for one stream: a ring the reader fills, the workers process in any order and the
+ * writer drains in input order. Once writing fails the remaining blocks are dropped and reading stops.
+ */
+class OrderedBlocks {
+public:
+    struct Block {
+        std::string input;      // the lines, when they had to be read in
+        std::string_view lines; // the lines to process: input, or a range of text that outlives the run
+        std::string output;
+        bool ready = false;
+    };
+
+private:
+    std::vector<Block> ring_;
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    size_t read_ = 0, written_ = 0;
+    bool exhausted_ = false, failed_ = false;
+
+public:
+    // A reader filling one block and the writer draining another while the workers have the rest
+    explicit OrderedBlocks(const size_t slots) : ring_(slots) {
+    }
+
+    // The next block for the reader to fill, once one is free, or nullptr once writing has failed
+    Block *
+    acquire() {
+        std::unique_lock lock(mutex_);
+        changed_.wait(lock, [&] { return read_ - written_ < ring_.size(); });
+        return failed_ ? nullptr : &ring_[read_ % ring_.size()];
+    }
+
+    // Marks the block acquire returned as handed to the workers
+    void
+    submitted() {
+        std::scoped_lock lock(mutex_);
+        ++read_;
+    }
+
+    // Marks the input exhausted, once nothing more will be acquired
+    void
+    close() {
+        std::scoped_lock lock(mutex_);
+        exhausted_ = true;
+        changed_.notify_all();
+    }
+
+    // Notifies under the lock: once the last block is out the writer may return and the stream go away
+    void
+    complete(Block &block) {
+        std::scoped_lock lock(mutex_);
+        block.ready = true;
+        changed_.notify_all();
+    }
+
+    // The next block in input order once processed, or nullptr once every block has been written
+    Block *
+    next() {
+        std::unique_lock lock(mutex_);
+        changed_.wait(lock, [&] { return ring_[written_ % ring_.size()].ready || (exhausted_ && written_ == read_); });
+        Block &block = ring_[written_ % ring_.size()];
+        return block.ready ? &block : nullptr;
+    }
+
+    // Hands the block next returned back to the reader, ok being whether it was written
+    void
+    release(Block &block, const bool ok) {
+        std::scoped_lock lock(mutex_);
+        block.ready = false;
+        failed_ = failed_ || !ok;
+        ++written_;
+        changed_.notify_all();
+    }
+
+    [[nodiscard]] bool
+    failed() {
+        std::scoped_lock lock(mutex_);
+        return failed_;
+    }
+};
+
+/**
+ * @name LinePool
+ * @brief Worker threads running their own line function over blocks of lines. Any number of streams can share one
+ * pool, each with its own OrderedBlocks, so a pool sized to the machine serves all of them.
+ */
+class LinePool {
+    struct Job {
+        OrderedBlocks *blocks;
+        OrderedBlocks::Block *block;
+    };
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<Job> queue_;
+    bool stopping_ = false;
+    std::vector<std::jthread> workers_;
+
+    template<typename TProcess>
+    void
+    work(TProcess &process) {
+        while (true) {
+            std::unique_lock lock(mutex_);
+            changed_.wait(lock, [&] { return !queue_.empty() || stopping_; });
+            if (queue_.empty()) {
+                return;
+            }
+            const Job job = queue_.front();
+            queue_.pop_front();
+            lock.unlock();
+            job.block->output.clear();
+            process_lines(job.block->lines, job.block->output, process);
+            job.blocks->complete(*job.block);
+        }
+    }
+
+public:
+    /**
+     * @param make_process Called once for each worker for that worker's line function, which appends the output for
+     * one line, without its newline, to a string: void(std::string_view line, std::string &out)
+     */
+    template<typename TMakeProcess>
+    LinePool(const size_t threads, const TMakeProcess &make_process) {
+        for (size_t t = 0; t < threads; ++t) {
+            workers_.emplace_back([this, process = make_process()]() mutable { work(process); });
+        }
+    }
+
+    LinePool(const LinePool &) = delete;
+    LinePool &operator=(const LinePool &) = delete;
+
+    ~LinePool() {
+        {
+            std::scoped_lock lock(mutex_);
+            stopping_ = true;
+        }
+        changed_.notify_all();
+    }
+
+    [[nodiscard]] size_t
+    size() const noexcept {
+        return workers_.size();
+    }
+
+    /**
+     * @name run
+     * @brief Processes one stream, reading on the calling thread and writing on another, in input order.
+     * @param read Fills a block with whole lines, bool(std::string &block), or points it at whole lines of text that
+     * outlives the run, bool(std::string_view &block); false once the input is exhausted
+     * @param write Writes the output for a block: bool(const std::string &output), false on failure
+     * @return false if writing failed
+     */
+    template<typename TRead, typename TWrite>
+    bool
+    run(OrderedBlocks &blocks, TRead &&read, TWrite &&write) {
+        std::jthread writer([&] {
+            while (OrderedBlocks::Block *block = blocks.next()) {
+                // after the first error the remaining blocks are dropped
+                blocks.release(*block, !blocks.failed() && write(block->output));
+            }
+        });
+        while (OrderedBlocks::Block *block = blocks.acquire()) {
+            // the slot is free until it is submitted
+            bool filled;
+            if constexpr (std::is_invocable_r_v<bool, TRead &, std::string &>) {
+                filled = read(block->input);
+                block->lines = block->input;
+            } else {
+                filled = read(block->lines);
+            }
+            if (!filled) {
+                break;
+            }
+            blocks.submitted();
+            {
+                std::scoped_lock lock(mutex_);
+                queue_.push_back({&blocks, block});
+            }
+            changed_.notify_one();
+        }
+        blocks.close();
+        writer.join();
+        return !blocks.failed();
+    }
+};
+
+/**
+ * @name process_lines_parallel
+ * @brief Processes istream line by line on threads workers, writing the output in input order.
+ * @param write Writes the output for a block of lines: bool(const std::string &output), false on failure
+ * @param make_process Called once for each worker for that worker's line function, which appends the output for one
+ * line, without its newline, to a string: void(std::string_view line, std::string &out)
+ * @return false if reading or writing failed
+ */
+template<typename TMakeProcess, typename TWrite>
+requires std::predicate<TWrite &, const std::string &>
+bool
+process_lines_parallel(std::istream &istream, TWrite &&write, const size_t threads, const TMakeProcess &make_process,
+                       const size_t block_size = ParallelBlockSize
+) {
+    LinePool pool(threads, make_process);
+    OrderedBlocks blocks(2 * threads);
+    std::string carry;
+    const bool written = pool.run(blocks,
+        [&](std::string &block) { return read_lines(istream, block, carry, block_size); }, write);
+    return written && !istream.bad();
+}
+
+/**
+ * @name process_lines_parallel
+ * @brief Processes istream line by line on threads workers, writing to ostream in input order.
+ * @return false if reading or writing failed
+ */
+template<typename TMakeProcess>
+bool
+process_lines_parallel(std::istream &istream, std::ostream &ostream, const size_t threads,
+                       const TMakeProcess &make_process, const size_t block_size = ParallelBlockSize
+) {
+    const bool processed = process_lines_parallel(istream, [&](const std::string &output) {
+        return static_cast<bool>(ostream.write(output.data(), static_cast<std::streamsize>(output.size())));
+    }, threads, make_process, block_size);
+    return processed && ostream.flush();
+}
+
+/**
+ * @name process_lines_parallel
+ * @brief Processes text, a mapped file or anything else already in memory, line by line on threads workers, writing
+ * the output in input order. The workers read their lines straight out of text, nothing of it is copied.
+ * @param write As for the istream overload
+ * @return false if writing failed
+ */
+template<typename TMakeProcess, typename TWrite>
+bool
+process_lines_parallel(std::string_view text, TWrite &&write, const size_t threads, const TMakeProcess &make_process,
+                       const size_t block_size = ParallelBlockSize
+) {
+    LinePool pool(threads, make_process);
+    OrderedBlocks blocks(2 * threads);
+    return pool.run(blocks, [&](std::string_view &block) { return next_lines(text, block, block_size); }, write);
+}
+
+} // namespace baybayin
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <baybayin-core/util/chars.h>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Vectorized classification of ASCII text, shared by the normalizer and the transliterator.
+// Define BAYBAYIN_SCALAR_SCAN to force the scalar kernel; both kernels produce identical blocks.
+
+namespace baybayin {
+
+inline constexpr size_t ScanWidth = 32;
+
+/**
+ * @name ScanMasks
+ * @brief One bit per byte of a block, bit k describing byte k.
+ */
+struct ScanMasks {
+    uint32_t vowel = 0;       // a, e, i, o, u in either case
+    uint32_t consonant = 0;   // any other ASCII letter
+    uint32_t space = 0;       // ' ', \t, \n, \v, \f, \r (std::isspace in the "C" locale)
+    uint32_t punctuation = 0; // printable ASCII that is not a letter or digit
+    uint32_t non_ascii = 0;   // UTF-8 lead and continuation bytes
+};
+
+struct ScanBlock {
+    alignas(ScanWidth) std::array<char, ScanWidth> lower{};
+    ScanMasks masks;
+};
+
+/**
+ * @name scan_block_scalar
+ * @brief Classifies and lowercases up to ScanWidth bytes. Mask bits past size are left clear.
+ */
+inline void
+scan_block_scalar(const char *data, const size_t size, ScanBlock &block) noexcept {
+    ScanMasks masks;
+    for (size_t k = 0; k < size; ++k) {
+        const char c = data[k];
+        const uint8_t cls = byte_class(c);
+        const uint32_t bit = uint32_t{1} << k;
+        block.lower[k] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+        masks.vowel |= cls & ByteVowel ? bit : 0;
+        masks.consonant |= cls & ByteConsonant ? bit : 0;
+        masks.space |= cls & ByteSpace ? bit : 0;
+        masks.punctuation |= cls & BytePunctuation ? bit : 0;
+        masks.non_ascii |= cls & ByteNonAscii ? bit : 0;
+    }
+    block.masks = masks;
+}
+
+#if defined(__SSE2__)
+[[gnu::always_inline]] inline void
+scan_half_sse2(const char *data, char *lower, ScanMasks &masks, const unsigned shift) noexcept {
+    const auto in_range = [](const __m128i v, const char lo, const char hi) {
+        return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                             _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(hi + 1)), v));
+    };
+    const auto equals = [](const __m128i v, const char c) {
+        return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+    };
+    const auto bits = [shift](const __m128i v) {
+        return static_cast<uint32_t>(_mm_movemask_epi8(v)) << shift;
+    };
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+    const __m128i l = _mm_or_si128(x, _mm_and_si128(in_range(x, 'A', 'Z'), _mm_set1_epi8(0x20)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lower), l);
+
+    const __m128i letter = in_range(l, 'a', 'z');
+    const __m128i vowel = _mm_or_si128(_mm_or_si128(equals(l, 'a'), equals(l, 'e')),
+                                       _mm_or_si128(_mm_or_si128(equals(l, 'i'), equals(l, 'o')), equals(l, 'u')));
+    const __m128i alnum = _mm_or_si128(letter, in_range(x, '0', '9'));
+    masks.vowel |= bits(vowel);
+    masks.consonant |= bits(_mm_andnot_si128(vowel, letter));
+    masks.space |= bits(_mm_or_si128(equals(x, ' '), in_range(x, '\t', '\r')));
+    masks.punctuation |= bits(_mm_andnot_si128(alnum, in_range(x, '!', '~')));
+    masks.non_ascii |= bits(x);
+}
+
+/**
+ * @name scan_block_sse2
+ * @brief Classifies and lowercases exactly ScanWidth bytes, 16 at a time.
+ */
+inline void
+scan_block_sse2(const char *data, ScanBlock &block) noexcept {
+    ScanMasks masks;
+    scan_half_sse2(data, block.lower.data(), masks, 0);
+    scan_half_sse2(data + 16, block.lower.data() + 16, masks, 16);
+    block.masks = masks;
+}
+#endif
+
+#if defined(__AVX2__)
+/**
+ * @name scan_block_avx2
+ * @brief Classifies and lowercases exactly ScanWidth bytes in one pass.
+ */
+inline void
+scan_block_avx2(const char *data, ScanBlock &block) noexcept {
+    const auto in_range = [](const __m256i v, const char lo, const char hi) {
+        return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+                                _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), v));
+    };
+    const auto equals = [](const __m256i v, const char c) {
+        return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+    };
+    const auto bits = [](const __m256i v) {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(v));
+    };
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+    const __m256i l = _mm256_or_si256(x, _mm256_and_si256(in_range(x, 'A', 'Z'), _mm256_set1_epi8(0x20)));
+    _mm256_store_si256(reinterpret_cast<__m256i *>(block.lower.data()), l);
+
+    const __m256i letter = in_range(l, 'a', 'z');
+    const __m256i vowel =
+    _mm256_or_si256(_mm256_or_si256(equals(l, 'a'), equals(l, 'e')),
+                    _mm256_or_si256(_mm256_or_si256(equals(l, 'i'), equals(l, 'o')), equals(l, 'u')));
+    const __m256i alnum = _mm256_or_si256(letter, in_range(x, '0', '9'));
+    block.masks.vowel = bits(vowel);
+    block.masks.consonant = bits(_mm256_andnot_si256(vowel, letter));
+    block.masks.space = bits(_mm256_or_si256(equals(x, ' '), in_range(x, '\t', '\r')));
+    block.masks.punctuation = bits(_mm256_andnot_si256(alnum, in_range(x, '!', '~')));
+    block.masks.non_ascii = bits(x);
+}
+#endif
+
+/**
+ * @name scan_block
+ * @brief Classifies and lowercases the next min(size, ScanWidth) bytes with the widest kernel available.
+ * Full blocks use AVX2 or SSE2 when compiled in, partial blocks at the end of the input are scanned scalar.
+ */
+inline void
+scan_block(const char *data, const size_t size, ScanBlock &block) noexcept {
+#if !defined(BAYBAYIN_SCALAR_SCAN) && defined(__AVX2__)
+    if (size >= ScanWidth) {
+        scan_block_avx2(data, block);
+        return;
+    }
+#elif !defined(BAYBAYIN_SCALAR_SCAN) && defined(__SSE2__)
+    if (size >= ScanWidth) {
+        scan_block_sse2(data, block);
+        return;
+    }
+#endif
+    scan_block_scalar(data, size < ScanWidth ? size : ScanWidth, block);
+}
+
+/**
+ * @name ascii_prefix
+ * @brief The number of bytes text starts with that are ASCII, checked a vector at a time, so text with no UTF-8 in
+ * it costs a load and a movemask per block.
+ */
+inline size_t
+ascii_prefix(const std::string_view text) noexcept {
+    size_t pos = 0;
+#if !defined(BAYBAYIN_SCALAR_SCAN) && defined(__AVX2__)
+    for (; pos + ScanWidth <= text.size(); pos += ScanWidth) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text.data() + pos));
+        if (const auto high = static_cast<uint32_t>(_mm256_movemask_epi8(x));
+            high != 0) {
+            return pos + static_cast<size_t>(std::countr_zero(high));
+        }
+    }
+#elif !defined(BAYBAYIN_SCALAR_SCAN) && defined(__SSE2__)
+    for (; pos + 16 <= text.size(); pos += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + pos));
+        if (const auto high = static_cast<uint32_t>(_mm_movemask_epi8(x));
+            high != 0) {
+            return pos + static_cast<size_t>(std::countr_zero(high));
+        }
+    }
+#endif
+    while (pos < text.size() && (byte_class(text[pos]) & ByteNonAscii) == 0) {
+        ++pos;
+    }
+    return pos;
+}
+
+/**
+ * @name for_each_word
+ * @brief Calls word(start, size) for each run of bytes outside whitespace and punctuation in text, the words as
+ * Words splits them, finding where they start and end a block of scan masks at a time.
+ */
+template<typename TWord>
+void
+for_each_word(const std::string_view text, TWord &&word) {
+    ScanBlock block;
+    size_t start = 0;
+    bool in_word = false;
+    for (size_t base = 0; base < text.size(); base += ScanWidth) {
+        const size_t width = std::min(ScanWidth, text.size() - base);
+        scan_block(text.data() + base, width, block);
+        const uint32_t valid = width == ScanWidth ? ~uint32_t{0} : (uint32_t{1} << width) - 1;
+        const uint32_t words = ~(block.masks.space | block.masks.punctuation) & valid;
+        // a bit for every byte that starts or ends a word
+        for (uint32_t edges = words ^ (words << 1 | uint32_t{in_word}); edges != 0; edges &= edges - 1) {
+            const size_t pos = base + static_cast<size_t>(std::countr_zero(edges));
+            if (in_word) {
+                word(start, pos - start);
+            } else {
+                start = pos;
+            }
+            in_word = !in_word;
+        }
+    }
+    if (in_word) {
+        word(start, text.size() - start);
+    }
+}
+
+} // namespace baybayin
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Instrumentation for the engines: how often each normalization rule fires, what glyphs transliteration emits and
+// the cycles spent in each stage. It is compiled in by defining BAYBAYIN_STATS, for the whole program since it
+// changes inline functions, and otherwise the hooks are empty and compile away. Each thread counts into Stats of
+// its own, plain integers with no atomics or sharing on the hot path, and collect_stats sums them.
+
+namespace baybayin {
+
+#ifdef BAYBAYIN_STATS
+inline constexpr bool StatsEnabled = true;
+#else
+inline constexpr bool StatsEnabled = false;
+#endif
+
+// The normalization passes, whose rules are counted apart
+enum class RulePass : uint8_t {
+    Consonants,
+    Vowels,
+};
+
+inline constexpr size_t RulePassCount = 2;
+
+// Counters for each pass, indexed by the order the rules were added in, see RuleSet::rule
+inline constexpr size_t StatsRuleSlots = 64;
+
+// What transliteration makes of the input
+enum class GlyphClass : uint8_t {
+    Vowel,       // a standalone vowel
+    Syllable,    // a consonant with its vowel
+    Coda,        // a consonant without a vowel, with a virama or left bare as the orthography has it
+    Punctuation, // whitespace and punctuation
+    Skipped,     // input bytes with no glyph, counted a byte each
+};
+
+inline constexpr size_t GlyphClassCount = 5;
+
+enum class Stage : uint8_t {
+    Consonants,
+    Vowels,
+    Transliterate,
+};
+
+inline constexpr size_t StageCount = 3;
+
+/**
+ * @name Stats
+ * @brief The counters of one thread, or the sum of several.
+ */
+struct Stats {
+    std::array<std::array<uint64_t, StatsRuleSlots>, RulePassCount> rules{};
+    std::array<uint64_t, GlyphClassCount> glyphs{};
+    std::array<uint64_t, StageCount> cycles{};
+    uint64_t bytes = 0; // input, counted by the caller
+
+    Stats &
+    operator+=(const Stats &other) noexcept {
+        for (size_t pass = 0; pass < RulePassCount; ++pass) {
+            std::ranges::transform(rules[pass], other.rules[pass], rules[pass].begin(), std::plus());
+        }
+        std::ranges::transform(glyphs, other.glyphs, glyphs.begin(), std::plus());
+        std::ranges::transform(cycles, other.cycles, cycles.begin(), std::plus());
+        bytes += other.bytes;
+        return *this;
+    }
+};
+
+/**
+ * @name cycles
+ * @brief The time stamp counter where there is one, nanoseconds of the steady clock elsewhere.
+ */
+inline uint64_t
+cycles() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/**
+ * @name StatsRegistry
+ * @brief The Stats of the running threads, and the sum of those of threads that have exited.
+ */
+class StatsRegistry {
+    std::mutex mutex_;
+    std::vector<const Stats *> live_;
+    Stats retired_;
+
+public:
+    void
+    add(const Stats &stats) {
+        std::scoped_lock lock(mutex_);
+        live_.push_back(&stats);
+    }
+
+    void
+    retire(const Stats &stats) {
+        std::scoped_lock lock(mutex_);
+        retired_ += stats;
+        std::erase(live_, &stats);
+    }
+
+    // Running threads are read without synchronizing with them, so they should be idle
+    Stats
+    collect() {
+        std::scoped_lock lock(mutex_);
+        Stats total = retired_;
+        for (const auto *stats : live_) {
+            total += *stats;
+        }
+        return total;
+    }
+};
+
+inline StatsRegistry &
+stats_registry() {
+    static StatsRegistry registry;
+    return registry;
+}
+
+/**
+ * @name thread_stats
+ * @brief The counters of the calling thread, registered for collect_stats on first use.
+ */
+inline Stats &
+thread_stats() {
+    thread_local struct Registered {
+        Stats stats;
+
+        Registered() {
+            stats_registry().add(stats);
+        }
+
+        ~Registered() {
+            stats_registry().retire(stats);
+        }
+    } registered;
+    return registered.stats;
+}
+
+/**
+ * @name collect_stats
+ * @brief The counters of every thread so far summed, once the threads still running are idle.
+ */
+inline Stats
+collect_stats() {
+    return stats_registry().collect();
+}
+
+template<RulePass Pass>
+[[gnu::always_inline]] inline void
+count_rule([[maybe_unused]] const size_t rule) noexcept {
+    if constexpr (StatsEnabled) {
+        thread_stats().rules[static_cast<size_t>(Pass)][rule]++;
+    }
+}
+
+template<GlyphClass Class>
+[[gnu::always_inline]] inline void
+count_glyphs([[maybe_unused]] const size_t count = 1) noexcept {
+    if constexpr (StatsEnabled) {
+        thread_stats().glyphs[static_cast<size_t>(Class)] += count;
+    }
+}
+
+/**
+ * @name StageTimer
+ * @brief Adds the cycles from its construction to its destruction to the stage.
+ */
+template<Stage Id>
+class StageTimer {
+    uint64_t start_ = 0;
+
+public:
+    [[gnu::always_inline]] StageTimer() noexcept {
+        if constexpr (StatsEnabled) {
+            start_ = cycles();
+        }
+    }
+
+    StageTimer(const StageTimer &) = delete;
+    StageTimer &operator=(const StageTimer &) = delete;
+
+    [[gnu::always_inline]] ~StageTimer() {
+        if constexpr (StatsEnabled) {
+            thread_stats().cycles[static_cast<size_t>(Id)] += cycles() - start_;
+        }
+    }
+};
+
+} // namespace baybayin
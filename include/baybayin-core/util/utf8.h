@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <baybayin-core/util/chars.h>
+#include <baybayin-core/util/scan.h>
+#include <baybayin-core/util/writer.h>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+// UTF-8 folded to what the rules know: the letters of Latin-1 Supplement and Latin Extended-A without their
+// diacritics, the no-break space as a space and curly quotes and dashes as their ASCII forms. ñ and Ñ are kept, the
+// rules spell them out. Anything else, invalid UTF-8 included, is copied as written, as before.
+
+namespace baybayin {
+
+/**
+ * @name Fold
+ * @brief What a code point folds to: at most as many ASCII bytes as its UTF-8 takes, or the code point as written.
+ */
+struct Fold {
+    std::array<char, 3> bytes{};
+    uint8_t size = 0;
+    bool keep = true;
+
+    constexpr Fold() = default;
+
+    constexpr explicit Fold(const std::string_view text) : size(static_cast<uint8_t>(text.size())), keep(false) {
+        for (size_t i = 0; i < text.size(); ++i) {
+            bytes[i] = text[i];
+        }
+    }
+};
+
+// The two byte code points folded, U+0080 to U+017F
+inline constexpr char32_t FoldFirst = 0x80;
+inline constexpr char32_t FoldLast = 0x17F;
+
+// The letters from U+00C0 on without their diacritics, * where the fold is not a single letter
+inline constexpr std::string_view FoldedLetters =
+    "AAAAAA*CEEEEIIIID*OOOOO*OUUUUY**aaaaaa*ceeeeiiiid*ooooo*ouuuuy*y"
+    "AaAaAaCcCcCcCcDdDdEeEeEeEeEeGgGgGgGgHhHhIiIiIiIiIi**JjKkkLlLlLlLlLlNnNnNn***OoOoOo**"
+    "RrRrRrSsSsSsSsTtTtTtUuUuUuUuUuUuWwYyYZzZzZzs";
+
+static_assert(FoldedLetters.size() == FoldLast + 1 - 0xC0);
+
+constexpr auto
+make_latin_folds() {
+    std::array<Fold, FoldLast + 1 - FoldFirst> table{};
+    for (char32_t c = 0xC0; c <= FoldLast; ++c) {
+        if (const char letter = FoldedLetters[c - 0xC0];
+            letter != '*') {
+            table[c - FoldFirst] = Fold(std::string_view(&letter, 1));
+        }
+    }
+    constexpr std::array<std::pair<char32_t, std::string_view>, 18> special{{
+        {0xA0, " "}, {0xA1, ""}, {0xAB, "\""}, {0xAD, ""}, {0xBB, "\""}, {0xBF, ""}, // ¡ and ¿ are dropped
+        {0xC6, "AE"}, {0xDE, "TH"}, {0xDF, "ss"}, {0xE6, "ae"}, {0xFE, "th"},
+        {0x132, "IJ"}, {0x133, "ij"}, {0x149, "n"}, {0x14A, "NG"}, {0x14B, "ng"}, {0x152, "OE"}, {0x153, "oe"},
+    }};
+    for (const auto &[c, text] : special) {
+        table[c - FoldFirst] = Fold(text);
+    }
+    return table;
+}
+
+// Indexed by code point less FoldFirst, ñ, Ñ, × and ÷ kept
+inline constexpr auto LatinFolds = make_latin_folds();
+
+/**
+ * @name fold_punctuation
+ * @brief The fold of a code point of General Punctuation, U+2000 to U+203F.
+ */
+constexpr Fold
+fold_punctuation(const char32_t c) noexcept {
+    if (c >= 0x2010 && c <= 0x2015) {
+        return Fold("-");
+    }
+    if (c >= 0x2018 && c <= 0x201B) {
+        return Fold("'");
+    }
+    if (c >= 0x201C && c <= 0x201F) {
+        return Fold("\"");
+    }
+    if (c == 0x2026) {
+        return Fold("...");
+    }
+    return {};
+}
+
+// Indexed by code point less U+2000
+inline constexpr auto PunctuationFolds = [] {
+    std::array<Fold, 0x40> table{};
+    for (char32_t c = 0; c < table.size(); ++c) {
+        table[c] = fold_punctuation(0x2000 + c);
+    }
+    return table;
+}();
+
+/**
+ * @name fold_sequence
+ * @brief Decodes the UTF-8 sequence at pos in text and folds it.
+ * @param fold What to write in its place
+ * @return The bytes it takes, a single byte for anything not folded, so the rest is copied a byte at a time
+ */
+inline size_t
+fold_sequence(const std::string_view text, const size_t pos, std::string_view &fold) noexcept {
+    const auto byte = [&](const size_t i) {
+        return pos + i < text.size() ? static_cast<unsigned char>(text[pos + i]) : 0u;
+    };
+    const auto continuation = [&](const size_t i) { return (byte(i) & 0xC0) == 0x80; };
+    const Fold *found = nullptr;
+    size_t length = 1;
+    if (const unsigned lead = byte(0);
+        lead >= 0xC2 && lead <= 0xC5 && continuation(1)) {
+        found = &LatinFolds[((lead & 0x1F) << 6 | (byte(1) & 0x3F)) - FoldFirst];
+        length = 2;
+    } else if (lead == 0xE2 && byte(1) == 0x80 && continuation(2)) {
+        found = &PunctuationFolds[byte(2) & 0x3F];
+        length = 3;
+    }
+    if (found == nullptr || found->keep) {
+        fold = text.substr(pos, 1);
+        return 1;
+    }
+    fold = std::string_view(found->bytes.data(), found->size);
+    return length;
+}
+
+/**
+ * @name fold_latin
+ * @brief Folds the UTF-8 in input. Runs of ASCII are found a vector at a time and copied whole, and input that is
+ * all ASCII is returned as it is without being copied at all. A fold is never longer than what it replaces.
+ * @param folded Replaced with the folded text if input needs any folding, its buffer reused across calls
+ * @return input or folded
+ */
+template<CharString TString>
+std::string_view
+fold_latin(const std::string_view input, TString &folded) {
+    size_t pos = ascii_prefix(input);
+    if (pos == input.size()) {
+        return input;
+    }
+    folded.clear();
+    folded.reserve(input.size());
+    size_t start = 0;
+    std::string_view fold;
+    while (pos < input.size()) {
+        folded.append(input.data() + start, pos - start);
+        pos += fold_sequence(input, pos, fold);
+        folded.append(fold);
+        start = pos;
+        pos += ascii_prefix(input.substr(pos));
+    }
+    folded.append(input.data() + start, pos - start);
+    return folded;
+}
+
+} // namespace baybayin
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <baybayin-core/util/chars.h>
+
 namespace phil_norm {
 
 enum class ForeignLanguage {
@@ -21,14 +23,20 @@ enum class InitialCluster {
     TRADITIONAL,
     REFORMED,
 };
+
+// The number of values of each, which the built-in rule and dispatch tables are generated for
+inline constexpr size_t ForeignLanguageCount = 2;
+inline constexpr size_t LatinOrthographyCount = 2;
+inline constexpr size_t InitialClusterCount = 2;
 }
 
+// Lowercase letters only, see baybayin::ByteClasses
 constexpr bool
 is_vowel(const char c) noexcept {
-    return (c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u');
+    return c >= 'a' && baybayin::byte_class(c) & baybayin::ByteVowel;
 }
 
 constexpr bool
 is_consonant(const char c) noexcept {
-    return (c >= 'a' && c <= 'z') && !is_vowel(c);
+    return c >= 'a' && baybayin::byte_class(c) & baybayin::ByteConsonant;
 }
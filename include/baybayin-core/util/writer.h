@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace baybayin {
+
+/**
+ * @name CharString
+ * @brief A std::string with any allocator, std::pmr::string among them. The entry points that append to a string
+ * take any of these, so the caller decides where its buffers come from.
+ */
+template<typename T>
+concept CharString = std::same_as<T, std::basic_string<char, std::char_traits<char>, typename T::allocator_type>>;
+
+/**
+ * @name StringWriter
+ * @brief Appends to a caller-owned string through a cursor, with the subset of the std::string interface the
+ * normalizer rules write with. Writes are unchecked: room for them has to be reserved first. finish() trims the
+ * string back to the bytes written.
+ */
+template<CharString TString = std::string>
+class StringWriter {
+    TString &out_;
+    size_t used_;
+    const size_t start_;
+
+public:
+    explicit StringWriter(TString &out) : out_(out), used_(out.size()), start_(out.size()) {
+    }
+
+    [[gnu::always_inline]] void
+    reserve(const size_t bytes) {
+        if (out_.size() - used_ < bytes) {
+            // double the room this writer has opened up, within the capacity already there, rather than clear the
+            // whole spare capacity: appending a line at a time to a large buffer stays linear
+            const size_t room = std::max(2 * bytes, out_.size() - start_);
+            out_.resize(std::max(used_ + bytes, std::min(used_ + room, out_.capacity())));
+        }
+    }
+
+    void
+    push_back(const char c) noexcept {
+        out_.data()[used_++] = c;
+    }
+
+    void
+    append(const char *data, const size_t size) noexcept {
+        std::memcpy(out_.data() + used_, data, size);
+        used_ += size;
+    }
+
+    void
+    append(const std::string_view text) noexcept {
+        append(text.data(), text.size());
+    }
+
+    // Appends size bytes of data by copying a whole block of TBlock, which data has to hold and room be reserved for
+    template<size_t TBlock>
+    [[gnu::always_inline]] void
+    append_block(const char *data, const size_t size) noexcept {
+        std::memcpy(out_.data() + used_, data, TBlock);
+        used_ += size;
+    }
+
+    void
+    append(const size_t count, const char c) noexcept {
+        std::memset(out_.data() + used_, c, count);
+        used_ += count;
+    }
+
+    [[nodiscard]] size_t
+    size() const noexcept {
+        return used_;
+    }
+
+    [[nodiscard]] std::string_view
+    view() const noexcept {
+        return {out_.data(), used_};
+    }
+
+    // Drops the bytes written past size, which has to be at most size()
+    void
+    resize(const size_t size) noexcept {
+        used_ = size;
+    }
+
+    // Drops the first count bytes written, moving the rest to the front
+    void
+    erase_front(const size_t count) noexcept {
+        std::memmove(out_.data(), out_.data() + count, used_ - count);
+        used_ -= count;
+    }
+
+    void
+    finish() {
+        out_.resize(used_);
+    }
+};
+
+} // namespace baybayin
@@ -0,0 +1,229 @@
+#include <baybayin-core/capi.h>
+#include <baybayin-core/norm.h>
+#include <baybayin-core/pipeline.h>
+#include <baybayin-core/tl.h>
+#include <cstring>
+#include <new>
+#include <string>
+#include <string_view>
+
+// libbaybayin: the C API over the header-only engines. Every entry point catches what the engines can throw, which
+// is std::bad_alloc while their buffers grow, and returns it as a status.
+
+using namespace baybayin;
+
+struct baybayin_engine {
+    phil_norm::Normalizer normalizer;
+    NormalizingTransliterator pipeline;
+    Orthography ortho;
+    Virama style;
+    size_t growth; // the most normalization writes per input byte
+    std::string output;
+
+    baybayin_engine(const ForeignLanguage language, const LatinOrthography latin, const Diphthong diphthongs,
+                    const InitialCluster clusters, const Orthography ortho, const Virama style
+    ) : normalizer(language, latin, diphthongs, clusters),
+        pipeline(language, latin, diphthongs, clusters, ortho, style), ortho(ortho), style(style),
+        growth(phil_norm::normalize_growth(language, latin, clusters)) {
+    }
+};
+
+namespace {
+
+// One glyph is at most a consonant and a virama, and takes at least one byte of input
+constexpr size_t GlyphGrowth = sizeof(Glyph::bytes);
+
+// Copies a result out of the engine, or reports the size it needs
+baybayin_status
+copy_out(const std::string_view result, char *output, const size_t output_capacity, size_t *output_size) {
+    *output_size = result.size();
+    if (result.size() > output_capacity) {
+        return BAYBAYIN_BUFFER_TOO_SMALL;
+    }
+    std::memcpy(output, result.data(), result.size());
+    return BAYBAYIN_OK;
+}
+
+baybayin_status
+run_normalize(baybayin_engine &engine, const std::string_view input, char *output, const size_t output_capacity,
+              size_t *output_size) {
+    return copy_out(engine.normalizer.normalize(input), output, output_capacity, output_size);
+}
+
+baybayin_status
+run_transliterate(baybayin_engine &engine, const std::string_view input, char *output,
+                  const size_t output_capacity, size_t *output_size) {
+    SpanSink sink({output, output_capacity});
+    transliterate(input, sink, engine.ortho, engine.style);
+    if (sink.overflow()) {
+        *output_size = baybayin_output_size(input, engine.ortho, engine.style);
+        return BAYBAYIN_BUFFER_TOO_SMALL;
+    }
+    *output_size = static_cast<size_t>(sink.cursor() - output);
+    return BAYBAYIN_OK;
+}
+
+baybayin_status
+run_normalize_transliterate(baybayin_engine &engine, const std::string_view input, char *output,
+                            const size_t output_capacity, size_t *output_size) {
+    engine.output.clear();
+    engine.pipeline.transliterate(input, engine.output);
+    return copy_out(engine.output, output, output_capacity, output_size);
+}
+
+// Runs a single call, checked and with any exception turned into a status
+template<typename TRun>
+baybayin_status
+single(baybayin_engine *engine, const char *input, const size_t input_size, char *output, const size_t output_capacity,
+       size_t *output_size, TRun &&run) noexcept {
+    if (engine == nullptr || output_size == nullptr || (input == nullptr && input_size > 0) ||
+        (output == nullptr && output_capacity > 0)) {
+        return BAYBAYIN_INVALID_ARGUMENT;
+    }
+    try {
+        return run(*engine, std::string_view(input, input_size), output, output_capacity, output_size);
+    } catch (const std::bad_alloc &) {
+        return BAYBAYIN_OUT_OF_MEMORY;
+    } catch (...) {
+        return BAYBAYIN_INVALID_ARGUMENT;
+    }
+}
+
+// Runs a batch call, each text into the room the ones before it left
+template<typename TRun>
+baybayin_status
+batch(baybayin_engine *engine, const char *input, const size_t *input_offsets, const size_t count, char *output,
+      const size_t output_capacity, size_t *output_offsets, TRun &&run) noexcept {
+    if (engine == nullptr || input_offsets == nullptr || output_offsets == nullptr ||
+        (input == nullptr && input_offsets[count] > 0) || (output == nullptr && output_capacity > 0)) {
+        return BAYBAYIN_INVALID_ARGUMENT;
+    }
+    try {
+        output_offsets[0] = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (input_offsets[i] > input_offsets[i + 1]) {
+                return BAYBAYIN_INVALID_ARGUMENT;
+            }
+            const std::string_view text(input + input_offsets[i], input_offsets[i + 1] - input_offsets[i]);
+            const size_t used = output_offsets[i];
+            size_t size;
+            if (const auto status = run(*engine, text, output + used, output_capacity - used, &size);
+                status != BAYBAYIN_OK) {
+                return status;
+            }
+            output_offsets[i + 1] = used + size;
+        }
+        return BAYBAYIN_OK;
+    } catch (const std::bad_alloc &) {
+        return BAYBAYIN_OUT_OF_MEMORY;
+    } catch (...) {
+        return BAYBAYIN_INVALID_ARGUMENT;
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+uint32_t
+baybayin_abi_version(void) {
+    return BAYBAYIN_ABI_VERSION;
+}
+
+void
+baybayin_config_init(baybayin_config *config) {
+    if (config == nullptr) {
+        return;
+    }
+    *config = {sizeof(baybayin_config), BAYBAYIN_SPANISH, BAYBAYIN_ABAKADA, BAYBAYIN_REFORMED, BAYBAYIN_REFORMED,
+               BAYBAYIN_REFORMED, BAYBAYIN_KRUS};
+}
+
+baybayin_status
+baybayin_engine_create(const baybayin_config *config, baybayin_engine **engine) {
+    if (config == nullptr || engine == nullptr || config->size < sizeof(baybayin_config)) {
+        return BAYBAYIN_INVALID_ARGUMENT;
+    }
+    const auto in_range = [](const int32_t value, const size_t count) {
+        return value >= 0 && static_cast<size_t>(value) < count;
+    };
+    if (!in_range(config->language, phil_norm::ForeignLanguageCount) ||
+        !in_range(config->latin_orthography, phil_norm::LatinOrthographyCount) ||
+        !in_range(config->diphthongs, 2) || !in_range(config->clusters, phil_norm::InitialClusterCount) ||
+        !in_range(config->orthography, 3) || !in_range(config->virama, 2)) {
+        return BAYBAYIN_INVALID_ARGUMENT;
+    }
+    try {
+        *engine = new baybayin_engine(static_cast<ForeignLanguage>(config->language),
+                                      static_cast<LatinOrthography>(config->latin_orthography),
+                                      static_cast<Diphthong>(config->diphthongs),
+                                      static_cast<InitialCluster>(config->clusters),
+                                      static_cast<Orthography>(config->orthography),
+                                      static_cast<Virama>(config->virama));
+    } catch (const std::bad_alloc &) {
+        return BAYBAYIN_OUT_OF_MEMORY;
+    }
+    return BAYBAYIN_OK;
+}
+
+void
+baybayin_engine_destroy(baybayin_engine *engine) {
+    delete engine;
+}
+
+baybayin_status
+baybayin_normalize(baybayin_engine *engine, const char *input, const size_t input_size, char *output,
+                   const size_t output_capacity, size_t *output_size) {
+    return single(engine, input, input_size, output, output_capacity, output_size, run_normalize);
+}
+
+baybayin_status
+baybayin_transliterate(baybayin_engine *engine, const char *input, const size_t input_size, char *output,
+                       const size_t output_capacity, size_t *output_size) {
+    return single(engine, input, input_size, output, output_capacity, output_size, run_transliterate);
+}
+
+baybayin_status
+baybayin_normalize_transliterate(baybayin_engine *engine, const char *input, const size_t input_size, char *output,
+                                 const size_t output_capacity, size_t *output_size) {
+    return single(engine, input, input_size, output, output_capacity, output_size,
+                  run_normalize_transliterate);
+}
+
+size_t
+baybayin_normalize_bound(const baybayin_engine *engine, const size_t input_size) {
+    return engine == nullptr ? 0 : input_size * engine->growth;
+}
+
+size_t
+baybayin_transliterate_bound(const baybayin_engine *engine, const size_t input_size) {
+    return engine == nullptr ? 0 : input_size * GlyphGrowth;
+}
+
+size_t
+baybayin_normalize_transliterate_bound(const baybayin_engine *engine, const size_t input_size) {
+    return engine == nullptr ? 0 : input_size * engine->growth * GlyphGrowth;
+}
+
+baybayin_status
+baybayin_normalize_batch(baybayin_engine *engine, const char *input, const size_t *input_offsets, const size_t count,
+                         char *output, const size_t output_capacity, size_t *output_offsets) {
+    return batch(engine, input, input_offsets, count, output, output_capacity, output_offsets, run_normalize);
+}
+
+baybayin_status
+baybayin_transliterate_batch(baybayin_engine *engine, const char *input, const size_t *input_offsets,
+                             const size_t count, char *output, const size_t output_capacity,
+                             size_t *output_offsets) {
+    return batch(engine, input, input_offsets, count, output, output_capacity, output_offsets, run_transliterate);
+}
+
+baybayin_status
+baybayin_normalize_transliterate_batch(baybayin_engine *engine, const char *input, const size_t *input_offsets,
+                                       const size_t count, char *output, const size_t output_capacity,
+                                       size_t *output_offsets) {
+    return batch(engine, input, input_offsets, count, output, output_capacity, output_offsets,
+                 run_normalize_transliterate);
+}
+
+}
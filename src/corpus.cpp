@@ -0,0 +1,46 @@
+#include <CLI/CLI.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include "include/corpus.h"
+#include "include/io.h"
+
+int main(const int argc, char **argv) {
+    CLI::App app{
+    "\nWrites a synthetic Taglish corpus for profiling: Tagalog text with Spanish and English loanwords that exercise "
+    "every normalizer rule. The same seed and size always give the same text.",
+    "baybayin-corpus"};
+    app.option_defaults()->always_capture_default();
+
+    size_t size_param = 1 << 20;
+    app.add_option("--size", size_param, "Bytes to write, rounded up to a whole line")->check(CLI::PositiveNumber);
+
+    uint64_t seed_param = 1;
+    app.add_option("--seed", seed_param);
+
+    std::filesystem::path output_param;
+    app.add_option("--output", output_param, "Output file, otherwise stdout");
+
+    CLI11_PARSE(app, argc, argv);
+
+    BlockWriter out(output_param);
+    if (!out.good()) {
+        std::cerr << "failed to open output: " << std::strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+    corpus::Generator generator(seed_param);
+    for (size_t written = 0; written < size_param;) {
+        const size_t before = out.buffer().size();
+        generator.line(out.buffer());
+        written += out.buffer().size() - before;
+        if (!out.flush_block()) {
+            std::cerr << "failed to write output: " << std::strerror(errno) << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (!out.flush()) {
+        std::cerr << "failed to write output: " << std::strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+
+// A synthetic Taglish corpus for profiling and throughput checks. Most words are Tagalog, built from its syllable
+// structure, with Spanish and English loanwords mixed in that reach every consonant rule of the normalizer: c before
+// hard and soft vowels, ch, ck, qu, q, ll, ph, x, z, j, f, v and ñ, as well as the English vowel rules. Sentences
+// are punctuated, lines hold a few of them and the whitespace between words varies. The same seed always produces
+// the same text, on any platform.
+
+namespace corpus {
+
+// Words common enough to be drawn by themselves
+inline constexpr auto FunctionWords = std::to_array<std::string_view>({
+    "ang", "ng", "sa", "mga", "ay", "na", "at", "ko", "mo", "siya", "ako", "ikaw", "kami", "tayo", "sila", "ito",
+    "iyon", "hindi", "oo", "po", "din", "rin", "lang", "pa", "na", "kasi", "pero", "para", "kung", "nang", "may",
+    "wala", "meron", "dito", "doon", "ni", "kay", "nga", "ba", "naman"});
+
+// Spanish loanwords, all spelled as in Spanish
+inline constexpr auto SpanishWords = std::to_array<std::string_view>({
+    "casa", "cocina", "cine", "cerveza", "cielo", "cuchara", "chico", "coche", "leche", "queso", "quince", "aquí",
+    "pequeño", "calle", "llave", "caballo", "pollo", "silla", "niño", "año", "señor", "señora", "España", "piña",
+    "baño", "mañana", "zapato", "azúcar", "cruz", "taxi", "examen", "extranjero", "jueves", "viernes", "jamón",
+    "ajo", "familia", "favor", "vaca", "verde", "escuela", "iglesia", "guitarra", "fiesta", "reloj", "ciudad"});
+
+// English loanwords, all spelled as in English
+inline constexpr auto EnglishWords = std::to_array<std::string_view>({
+    "computer", "cellphone", "phone", "photo", "elephant", "graph", "Philippines", "chocolate", "church", "school",
+    "Christmas", "technology", "jacket", "check", "quiz", "queen", "question", "Iraq", "ball", "yellow", "college",
+    "hello", "traffic", "music", "center", "cinema", "cake", "make", "rain", "day", "play", "august", "boat", "coat",
+    "green", "cheese", "office", "Friday", "favorite", "jeep", "juice", "xerox", "box", "extra", "zoo", "laptop",
+    "video", "university", "science", "coffee", "taxi", "email"});
+
+inline constexpr auto Onsets = std::to_array<std::string_view>({
+    "", "", "b", "k", "k", "d", "g", "h", "l", "m", "m", "n", "ng", "p", "p", "r", "s", "s", "t", "t", "w", "y"});
+
+// a, i and u are native, e and o mostly come with loanwords
+inline constexpr auto Vowels = std::to_array<char>({'a', 'a', 'a', 'a', 'i', 'i', 'i', 'u', 'u', 'o', 'e'});
+
+inline constexpr auto Codas = std::to_array<std::string_view>({
+    "", "", "", "", "", "n", "ng", "ng", "t", "s", "l", "k", "m", "y", "w", "p", "r", "d"});
+
+inline constexpr auto Separators = std::to_array<std::string_view>({
+    " ", " ", " ", " ", " ", " ", " ", " ", " ", " ", " ", " ", "  ", "\t", " \t"});
+
+/**
+ * @name Generator
+ * @brief Writes the corpus a line at a time. std::mt19937_64 is fully specified by the standard and the draws below
+ * do not go through the standard distributions, whose results may differ between libraries.
+ */
+class Generator {
+    std::mt19937_64 random_;
+    std::string word_;
+
+    // A number in [0, count)
+    size_t
+    draw(const size_t count) {
+        return static_cast<size_t>(random_() % count);
+    }
+
+    template<typename T, size_t N>
+    const T &
+    pick(const std::array<T, N> &choices) {
+        return choices[draw(N)];
+    }
+
+    void
+    tagalog_word(std::string &out) {
+        const size_t syllables = 1 + draw(3) + draw(2);
+        for (size_t s = 0; s < syllables; ++s) {
+            out.append(pick(Onsets));
+            out.push_back(pick(Vowels));
+            // codas mostly close the last syllable
+            if (s + 1 == syllables || draw(3) == 0) {
+                out.append(pick(Codas));
+            }
+        }
+    }
+
+    void
+    word(std::string &out) {
+        const size_t kind = draw(20);
+        if (kind < 11) {
+            word_.clear();
+            tagalog_word(word_);
+            out.append(word_);
+            if (draw(25) == 0) {
+                // reduplicated, as in gustong-gusto
+                out.push_back('-');
+                out.append(word_);
+            }
+        } else if (kind < 15) {
+            out.append(pick(FunctionWords));
+        } else if (kind < 18) {
+            out.append(pick(SpanishWords));
+        } else {
+            out.append(pick(EnglishWords));
+        }
+    }
+
+    void
+    sentence(std::string &out) {
+        const size_t words = 3 + draw(12);
+        const size_t start = out.size();
+        for (size_t w = 0; w < words; ++w) {
+            if (w > 0) {
+                if (draw(9) == 0) {
+                    out.push_back(',');
+                }
+                out.append(pick(Separators));
+            }
+            word(out);
+        }
+        if (out[start] >= 'a' && out[start] <= 'z') {
+            out[start] = static_cast<char>(out[start] - 'a' + 'A');
+        }
+        constexpr std::string_view stops = "....!?";
+        out.push_back(stops[draw(stops.size())]);
+    }
+
+public:
+    explicit Generator(const uint64_t seed) : random_(seed) {
+    }
+
+    /**
+     * @name line
+     * @brief Appends the next line, with its newline, to out. Some lines are blank and some end in spaces.
+     */
+    void
+    line(std::string &out) {
+        if (draw(40) == 0) {
+            out.push_back('\n');
+            return;
+        }
+        const size_t sentences = 1 + draw(4);
+        for (size_t s = 0; s < sentences; ++s) {
+            if (s > 0) {
+                out.append(pick(Separators));
+            }
+            sentence(out);
+        }
+        if (draw(20) == 0) {
+            out.append("  ");
+        }
+        out.push_back('\n');
+    }
+};
+
+} // namespace corpus
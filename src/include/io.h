@@ -0,0 +1,325 @@
+#pragma once
+
+#include <algorithm>
+#include <baybayin-core/util/parallel.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "utils.h"
+
+// Line I/O for the CLIs without iostreams on the common path. A regular input file is mapped and its lines are
+// handed to the engines as views into the mapping, output is gathered in a large buffer written out with one
+// write(2) a block, and only input that cannot be mapped, stdin and pipes, is still read through an istream.
+
+inline constexpr size_t OutputBlockSize = 1 << 20;
+
+inline constexpr size_t InputReadSize = 1 << 16;
+
+/**
+ * @name write_all
+ * @brief Writes all of data to fd, retrying partial and interrupted writes.
+ * @return false on failure, with errno set
+ */
+inline bool
+write_all(const int fd, const std::string_view data) {
+    for (size_t done = 0; done < data.size();) {
+        const ssize_t written = ::write(fd, data.data() + done, data.size() - done);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        done += static_cast<size_t>(written);
+    }
+    return true;
+}
+
+/**
+ * @name read_available
+ * @brief Reads the whole lines that have arrived on fd into block, waiting for at least one. Unlike read_lines this
+ * never waits for more input than it needs, so a lone request on a socket or pipe is answered at once. The partial
+ * line left at the end is kept in carry and starts the next block.
+ * @return false once the input is exhausted or cannot be read
+ */
+inline bool
+read_available(const int fd, std::string &block, std::string &carry) {
+    block.swap(carry);
+    carry.clear();
+    while (true) {
+        const size_t filled = block.size();
+        block.resize(filled + InputReadSize);
+        const ssize_t count = ::read(fd, block.data() + filled, InputReadSize);
+        block.resize(filled + static_cast<size_t>(std::max<ssize_t>(count, 0)));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return !block.empty();
+        }
+        if (const size_t eol = block.rfind('\n');
+            eol != std::string::npos && eol >= filled) {
+            carry.assign(block, eol + 1);
+            block.resize(eol + 1);
+            return true;
+        }
+    }
+}
+
+/**
+ * @name MappedFile
+ * @brief A read-only mapping of a whole regular file. Anything else, and empty files, are left unmapped for the
+ * caller to read as a stream.
+ */
+class MappedFile {
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+
+public:
+    /**
+     * @param advice How the mapping will be read, for madvise(2): read front to back by default
+     */
+    explicit MappedFile(const std::filesystem::path &fn, const int advice = MADV_SEQUENTIAL) {
+        if (fn.empty()) {
+            return;
+        }
+        const int fd = ::open(fn.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        if (struct stat status{};
+            ::fstat(fd, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0) {
+            const auto size = static_cast<size_t>(status.st_size);
+            if (void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                data != MAP_FAILED) {
+                ::madvise(data, size, advice);
+                data_ = static_cast<const char *>(data);
+                size_ = size;
+            }
+        }
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile() {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char *>(data_), size_);
+        }
+    }
+
+    explicit operator bool() const noexcept {
+        return data_ != nullptr;
+    }
+
+    [[nodiscard]] std::string_view
+    view() const noexcept {
+        return {data_, size_};
+    }
+};
+
+/**
+ * @name BlockWriter
+ * @brief Output to stdout or a file through a buffer the engines append to directly. The buffer is written out
+ * once it holds a block, so a run makes one write(2) a megabyte rather than a flush a line.
+ */
+class BlockWriter {
+    int fd_;
+    bool owned_;
+    std::string buffer_;
+
+public:
+    explicit BlockWriter(const std::filesystem::path &fn)
+    : fd_(fn.empty() ? STDOUT_FILENO : ::open(fn.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666)),
+      owned_(!fn.empty()) {
+        buffer_.reserve(OutputBlockSize + OutputBlockSize / 4);
+    }
+
+    BlockWriter(const BlockWriter &) = delete;
+    BlockWriter &operator=(const BlockWriter &) = delete;
+
+    ~BlockWriter() {
+        flush();
+        if (owned_ && fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    [[nodiscard]] bool
+    good() const noexcept {
+        return fd_ >= 0;
+    }
+
+    // The pending output, for the engines to append to
+    std::string &
+    buffer() noexcept {
+        return buffer_;
+    }
+
+    // Writes the buffer out if it holds a block
+    bool
+    flush_block() {
+        return buffer_.size() < OutputBlockSize || flush();
+    }
+
+    // Ends the line just appended, as flush_block
+    bool
+    end_line() {
+        buffer_.push_back('\n');
+        return flush_block();
+    }
+
+    bool
+    flush() {
+        const bool written = write_all(fd_, buffer_);
+        buffer_.clear();
+        return written;
+    }
+
+    // Writes data out after the pending output, straight from where it is rather than through the buffer
+    bool
+    write(const std::string_view data) {
+        return flush() && write_all(fd_, data);
+    }
+};
+
+/**
+ * @name write_lines
+ * @brief Runs process over every line of text, each followed by a newline in out. A last line without a newline
+ * gets one, as with std::getline.
+ * @param process Appends the output for one line to a string: void(std::string_view line, std::string &out)
+ * @return false if writing failed
+ */
+template<typename TProcess>
+bool
+write_lines(const std::string_view text, BlockWriter &out, TProcess &process) {
+    for (size_t start = 0; start < text.size();) {
+        size_t end = text.find('\n', start);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        process(text.substr(start, end - start), out.buffer());
+        if (!out.end_line()) {
+            return false;
+        }
+        start = end + 1;
+    }
+    return true;
+}
+
+/**
+ * @name write_lines
+ * @brief Runs process over every line read from istream, each followed by a newline in out.
+ * @return false if writing failed
+ */
+template<typename TProcess>
+bool
+write_lines(std::istream &istream, BlockWriter &out, TProcess &process) {
+    std::string line;
+    while (std::getline(istream, line)) {
+        process(std::string_view(line), out.buffer());
+        if (!out.end_line()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @name process_input
+ * @brief Runs process over the input file, or stdin if none, line by line into the output file, or stdout if none.
+ * The input file is mapped where it can be.
+ * @param read_stream Reads input that cannot be mapped instead of write_lines: bool(std::istream &, BlockWriter &)
+ * @return The exit code
+ */
+template<typename TProcess, typename TReadStream>
+int
+process_input(const std::filesystem::path &input, const std::filesystem::path &output, TProcess &&process,
+              TReadStream &&read_stream
+) {
+    BlockWriter out(output);
+    if (!out.good()) {
+        std::cerr << "failed to write output: " << std::strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+    bool written;
+    if (const MappedFile mapped(input);
+        mapped) {
+        written = write_lines(mapped.view(), out, process);
+    } else if (const auto istream = get_input_stream(input);
+               istream->good()) {
+        written = read_stream(*istream, out);
+        if (istream->bad()) {
+            std::cerr << "Error reading input: " << std::strerror(errno) << std::endl;
+            return EXIT_FAILURE;
+        }
+    } else {
+        std::cerr << "failed to read input: " << std::strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!written || !out.flush()) {
+        std::cerr << "Error writing output: " << std::strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @name process_input
+ * @brief Runs process over the input file, or stdin if none, line by line into the output file, or stdout if none.
+ * @return The exit code
+ */
+template<typename TProcess>
+int
+process_input(const std::filesystem::path &input, const std::filesystem::path &output, TProcess &&process) {
+    return process_input(input, output, process, [&process](std::istream &istream, BlockWriter &out) {
+        return write_lines(istream, out, process);
+    });
+}
+
+/**
+ * @name process_parallel
+ * @brief Runs the input file, or stdin if none, line by line on threads workers, each with the line function
+ * make_process returns, into the output file, or stdout if none. A mapped input file is handed to the workers as
+ * ranges of the mapping, input that cannot be mapped is read a block at a time, and each block of output is written
+ * with one write(2).
+ * @return The exit code
+ */
+template<typename TMakeProcess>
+int
+process_parallel(const std::filesystem::path &input, const std::filesystem::path &output, const size_t threads,
+                 const TMakeProcess &make_process
+) {
+    BlockWriter out(output);
+    if (!out.good()) {
+        std::cerr << "failed to write output: " << std::strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+    const auto write = [&out](const std::string &block) { return out.write(block); };
+    bool processed;
+    if (const MappedFile mapped(input);
+        mapped) {
+        processed = baybayin::process_lines_parallel(mapped.view(), write, threads, make_process);
+    } else if (const auto istream = get_input_stream(input);
+               istream->good()) {
+        processed = baybayin::process_lines_parallel(*istream, write, threads, make_process);
+    } else {
+        std::cerr << "failed to read input: " << std::strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!processed || !out.flush()) {
+        std::cerr << "Error processing input: " << std::strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
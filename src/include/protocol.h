@@ -0,0 +1,460 @@
+#pragma once
+
+#include <baybayin-core/norm.h>
+#include <baybayin-core/pipeline.h>
+#include <baybayin-core/tl.h>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+// The baybayin-server protocol: JSON lines, one request object a line answered by one response object on the line
+// in the same position. A request names the tool, the text and any settings, with the names and values of the tl
+// and norm options:
+//
+//   {"id": 7, "tool": "tl", "text": "pagmamahal", "orthography": "traditional", "virama": "pamudpod"}
+//   {"id": "a", "tool": "tl", "normalize": true, "text": "xerox", "language": "english"}
+//   {"tool": "tl", "reverse": true, "text": "ᜊᜑᜌ᜔"}
+//   {"tool": "norm", "text": "chocolate", "latin-orthography": "alpabetong", "diphthong": "traditional"}
+//
+// and gets {"id": 7, "text": "..."} back, or {"id": 7, "error": "..."} for a request it could not read. The id, any
+// JSON scalar, is echoed as it was sent and left out when the request has none.
+
+struct Request {
+    std::string id; // as sent, empty if none
+    std::string text;
+    bool norm = false;
+    bool reverse = false;
+    bool normalize = false;
+    baybayin::Orthography ortho = baybayin::Orthography::Reformed;
+    baybayin::Virama style = baybayin::Virama::Krus;
+    ForeignLanguage language = ForeignLanguage::SPANISH;
+    LatinOrthography latin = LatinOrthography::ABAKADA;
+    Diphthong diphthongs = Diphthong::REFORMED;
+    InitialCluster clusters = InitialCluster::REFORMED;
+};
+
+/**
+ * @name append_json_string
+ * @brief Appends text to out as a quoted JSON string. UTF-8 is passed through, only quotes, backslashes and control
+ * characters are escaped.
+ */
+inline void
+append_json_string(const std::string_view text, std::string &out) {
+    constexpr std::string_view hex = "0123456789abcdef";
+    out.push_back('"');
+    size_t run = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        const auto c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out.append(text, run, i - run);
+        run = i + 1;
+        out.push_back('\\');
+        switch (c) {
+        case '"':
+        case '\\':
+            out.push_back(static_cast<char>(c));
+            break;
+        case '\n':
+            out.push_back('n');
+            break;
+        case '\r':
+            out.push_back('r');
+            break;
+        case '\t':
+            out.push_back('t');
+            break;
+        default:
+            out.append("u00");
+            out.push_back(hex[c >> 4]);
+            out.push_back(hex[c & 0xF]);
+        }
+    }
+    out.append(text, run);
+    out.push_back('"');
+}
+
+/**
+ * @name JsonReader
+ * @brief Just enough of a JSON parser for a request: one flat object of strings, booleans, numbers and null.
+ */
+class JsonReader {
+    std::string_view json_;
+    size_t pos_ = 0;
+
+    static void
+    append_utf8(const uint32_t code, std::string &out) {
+        if (code < 0x80) {
+            out.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | code >> 6));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | code >> 12));
+            out.push_back(static_cast<char>(0x80 | (code >> 6 & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | code >> 18));
+            out.push_back(static_cast<char>(0x80 | (code >> 12 & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code >> 6 & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
+
+    bool
+    hex4(uint32_t &code) {
+        if (json_.size() - pos_ < 4) {
+            return false;
+        }
+        code = 0;
+        for (const char c : json_.substr(pos_, 4)) {
+            code <<= 4;
+            if (c >= '0' && c <= '9') {
+                code |= c - '0';
+            } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+                code |= (c | 0x20) - 'a' + 10;
+            } else {
+                return false;
+            }
+        }
+        pos_ += 4;
+        return true;
+    }
+
+public:
+    explicit JsonReader(const std::string_view json) : json_(json) {
+    }
+
+    // Whether text is a JSON number: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+    static bool
+    is_number(const std::string_view text) {
+        size_t pos = 0;
+        const auto digits = [&] {
+            const size_t start = pos;
+            while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+                ++pos;
+            }
+            return pos > start;
+        };
+        if (pos < text.size() && text[pos] == '-') {
+            ++pos;
+        }
+        if (pos < text.size() && text[pos] == '0') {
+            ++pos;
+        } else if (!digits()) {
+            return false;
+        }
+        if (pos < text.size() && text[pos] == '.' && (++pos, !digits())) {
+            return false;
+        }
+        if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+            if (++pos < text.size() && (text[pos] == '+' || text[pos] == '-')) {
+                ++pos;
+            }
+            if (!digits()) {
+                return false;
+            }
+        }
+        return pos == text.size();
+    }
+
+    void
+    skip_space() {
+        while (pos_ < json_.size() && (json_[pos_] == ' ' || json_[pos_] == '\t' || json_[pos_] == '\r' ||
+                                       json_[pos_] == '\n')) {
+            ++pos_;
+        }
+    }
+
+    // Consumes c, after any whitespace, if it is next
+    bool
+    consume(const char c) {
+        skip_space();
+        if (pos_ < json_.size() && json_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool
+    at_end() {
+        skip_space();
+        return pos_ == json_.size();
+    }
+
+    bool
+    string(std::string &out) {
+        if (!consume('"')) {
+            return false;
+        }
+        out.clear();
+        while (pos_ < json_.size()) {
+            const size_t end = json_.find_first_of("\"\\", pos_);
+            if (end == std::string_view::npos) {
+                return false;
+            }
+            out.append(json_, pos_, end - pos_);
+            pos_ = end + 1;
+            if (json_[end] == '"') {
+                return true;
+            }
+            if (pos_ == json_.size()) {
+                return false;
+            }
+            switch (const char c = json_[pos_++]) {
+            case '"':
+            case '\\':
+            case '/':
+                out.push_back(c);
+                break;
+            case 'b':
+                out.push_back('\b');
+                break;
+            case 'f':
+                out.push_back('\f');
+                break;
+            case 'n':
+                out.push_back('\n');
+                break;
+            case 'r':
+                out.push_back('\r');
+                break;
+            case 't':
+                out.push_back('\t');
+                break;
+            case 'u': {
+                uint32_t code;
+                if (!hex4(code)) {
+                    return false;
+                }
+                if (code >= 0xD800 && code < 0xDC00) {
+                    uint32_t low;
+                    if (json_.substr(pos_, 2) != "\\u") {
+                        return false;
+                    }
+                    pos_ += 2;
+                    if (!hex4(low) || low < 0xDC00 || low >= 0xE000) {
+                        return false;
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                } else if (code >= 0xDC00 && code < 0xE000) {
+                    return false;
+                }
+                append_utf8(code, out);
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+        return false;
+    }
+
+    // A string, number, boolean or null, as written
+    bool
+    scalar(std::string_view &raw) {
+        skip_space();
+        const size_t start = pos_;
+        if (pos_ < json_.size() && json_[pos_] == '"') {
+            std::string ignored;
+            if (!string(ignored)) {
+                return false;
+            }
+        } else {
+            constexpr std::string_view literal = "+-.0123456789Eaeflnrstu";
+            while (pos_ < json_.size() && literal.find(json_[pos_]) != std::string_view::npos) {
+                ++pos_;
+            }
+            raw = json_.substr(start, pos_ - start);
+            return is_number(raw) || raw == "true" || raw == "false" || raw == "null";
+        }
+        raw = json_.substr(start, pos_ - start);
+        return true;
+    }
+
+    bool
+    boolean(bool &value) {
+        std::string_view raw;
+        if (!scalar(raw) || (raw != "true" && raw != "false")) {
+            return false;
+        }
+        value = raw == "true";
+        return true;
+    }
+};
+
+/**
+ * @name parse_option
+ * @brief Matches value against the names of an option's choices, in the order of the enumerators.
+ */
+template<typename TEnum, size_t N>
+bool
+parse_option(const std::string_view value, const std::string_view (&names)[N], const std::string_view key,
+             TEnum &option, std::string &error
+) {
+    for (size_t i = 0; i < N; ++i) {
+        if (value == names[i]) {
+            option = static_cast<TEnum>(i);
+            return true;
+        }
+    }
+    error.assign("invalid ").append(key).append(": ").append(value);
+    return false;
+}
+
+/**
+ * @name parse_request
+ * @brief Reads one request line into request.
+ * @return false with error set if the line is not a request, request.id being set if it got that far
+ */
+inline bool
+parse_request(const std::string_view line, Request &request, std::string &error) {
+    static constexpr std::string_view Orthographies[] = {"traditional", "reformed"};
+    static constexpr std::string_view Viramas[] = {"krus", "pamudpod"};
+    static constexpr std::string_view Languages[] = {"spanish", "english"};
+    static constexpr std::string_view LatinOrthographies[] = {"abakada", "alpabetong"};
+    static constexpr std::string_view Reforms[] = {"traditional", "reformed"};
+    request = Request();
+    error.clear();
+    JsonReader reader(line);
+    if (!reader.consume('{')) {
+        error = "expected a JSON object";
+        return false;
+    }
+    std::string key, value;
+    bool has_text = false;
+    for (bool first = true; !reader.consume('}'); first = false) {
+        if ((!first && !reader.consume(',')) || !reader.string(key) || !reader.consume(':')) {
+            error = "malformed JSON object";
+            return false;
+        }
+        bool valid = true;
+        if (key == "id") {
+            std::string_view raw;
+            valid = reader.scalar(raw);
+            // only a valid id is echoed, the response has to stay valid JSON
+            if (valid) {
+                request.id = raw;
+            }
+        } else if (key == "reverse") {
+            valid = reader.boolean(request.reverse);
+        } else if (key == "normalize") {
+            valid = reader.boolean(request.normalize);
+        } else if (!reader.string(value)) {
+            valid = false;
+        } else if (key == "text") {
+            request.text.swap(value);
+            has_text = true;
+        } else if (key == "tool") {
+            if (value != "tl" && value != "norm") {
+                error = "invalid tool: " + value;
+                return false;
+            }
+            request.norm = value == "norm";
+        } else if (key == "orthography") {
+            valid = parse_option(value, Orthographies, key, request.ortho, error);
+        } else if (key == "virama") {
+            valid = parse_option(value, Viramas, key, request.style, error);
+        } else if (key == "language") {
+            valid = parse_option(value, Languages, key, request.language, error);
+        } else if (key == "latin-orthography") {
+            valid = parse_option(value, LatinOrthographies, key, request.latin, error);
+        } else if (key == "diphthong") {
+            valid = parse_option(value, Reforms, key, request.diphthongs, error);
+        } else if (key == "clusters") {
+            valid = parse_option(value, Reforms, key, request.clusters, error);
+        } else {
+            error = "unknown member: " + key;
+            return false;
+        }
+        if (!valid) {
+            if (error.empty()) {
+                error = "invalid value for " + key;
+            }
+            return false;
+        }
+    }
+    if (!reader.at_end()) {
+        error = "trailing characters after the request";
+        return false;
+    }
+    if (!has_text) {
+        error = "missing text";
+        return false;
+    }
+    if (request.reverse && (request.normalize || request.norm)) {
+        error = "reverse cannot be combined with normalize or norm";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @name Responder
+ * @brief Answers requests, one per worker. The engines for the last settings seen are kept, as consecutive requests
+ * mostly share them.
+ */
+class Responder {
+    Request request_;
+    std::string error_;
+    std::string result_;
+    std::optional<std::tuple<ForeignLanguage, LatinOrthography, Diphthong, InitialCluster>> settings_;
+    std::optional<Normalizer> normalizer_;
+    std::optional<baybayin::NormalizingTransliterator> pipeline_;
+    std::tuple<baybayin::Orthography, baybayin::Virama> pipeline_output_{};
+
+    void
+    run(const Request &request) {
+        const auto settings = std::tuple(request.language, request.latin, request.diphthongs, request.clusters);
+        if (settings_ != settings) {
+            settings_ = settings;
+            normalizer_.reset();
+            pipeline_.reset();
+        }
+        result_.clear();
+        if (request.norm) {
+            if (!normalizer_) {
+                normalizer_.emplace(request.language, request.latin, request.diphthongs, request.clusters);
+            }
+            normalizer_->normalize(request.text, result_);
+        } else if (request.reverse) {
+            baybayin::baybayin_to_latin(request.text, result_);
+        } else if (request.normalize) {
+            if (!pipeline_ || pipeline_output_ != std::tuple(request.ortho, request.style)) {
+                pipeline_.emplace(request.language, request.latin, request.diphthongs, request.clusters,
+                                  request.ortho, request.style);
+                pipeline_output_ = std::tuple(request.ortho, request.style);
+            }
+            pipeline_->transliterate(request.text, result_);
+        } else {
+            baybayin::latin_to_baybayin(request.text, result_, request.ortho, request.style);
+        }
+    }
+
+public:
+    /**
+     * @name respond
+     * @brief Appends the response to one request line to out, without a newline.
+     */
+    void
+    respond(const std::string_view line, std::string &out) {
+        const bool parsed = parse_request(line, request_, error_);
+        out.push_back('{');
+        if (!request_.id.empty()) {
+            out.append("\"id\":").append(request_.id).push_back(',');
+        }
+        if (!parsed) {
+            out.append("\"error\":");
+            append_json_string(error_, out);
+        } else {
+            run(request_);
+            out.append("\"text\":");
+            append_json_string(result_, out);
+        }
+        out.push_back('}');
+    }
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <baybayin-core/norm/languages.h>
+#include <baybayin-core/util/stats.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include "protocol.h"
+
+// --stats for the CLIs: the run is timed from start to end and what the engines counted is printed to stderr as one
+// JSON object. Throughput is always there; stages, rules and glyphs only in a build with BAYBAYIN_STATS. Words
+// served from a word cache skip the engines, so with --cache-size the rules only count their first occurrences.
+
+/**
+ * @name count_input
+ * @brief Counts a line of input, with its newline, for the throughput.
+ */
+inline void
+count_input(const std::string_view line) {
+    baybayin::thread_stats().bytes += line.size() + 1;
+}
+
+/**
+ * @name append_rule_label
+ * @brief Appends a rule as before[pattern]after > replacement, bytes outside ASCII written as \xNN, so a lone byte
+ * of a UTF-8 sequence still makes valid JSON.
+ */
+inline void
+append_rule_label(const phil_norm::Rule &rule, std::string &out) {
+    constexpr std::string_view hex = "0123456789abcdef";
+    const auto append = [&](const std::string_view text) {
+        for (const char c : text) {
+            if (const auto byte = static_cast<unsigned char>(c);
+                byte >= 0x80) {
+                out.append("\\x");
+                out.push_back(hex[byte >> 4]);
+                out.push_back(hex[byte & 0xF]);
+            } else {
+                out.push_back(c);
+            }
+        }
+    };
+    append(rule.before);
+    out.push_back('[');
+    append(rule.pattern);
+    out.push_back(']');
+    append(rule.after);
+    out.append(" > ");
+    append(rule.replacement.empty() ? "-" : rule.replacement);
+}
+
+/**
+ * @name StatsReport
+ * @brief Times a run from its construction to print.
+ */
+class StatsReport {
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+    uint64_t start_cycles_ = baybayin::cycles();
+
+public:
+    /**
+     * @name print
+     * @brief Prints the counters of every thread once the run is over.
+     * @param language The rules normalized with, whose hits are listed, none for transliteration alone
+     */
+    void
+    print(std::ostream &out, const phil_norm::Language *language) const {
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        const uint64_t elapsed = baybayin::cycles() - start_cycles_;
+        const auto stats = baybayin::collect_stats();
+        std::string json = "{\"instrumented\":";
+        json.append(baybayin::StatsEnabled ? "true" : "false");
+        json.append(",\"bytes\":").append(std::to_string(stats.bytes));
+        json.append(",\"seconds\":").append(std::to_string(seconds));
+        json.append(",\"mb_per_s\":").append(std::to_string(seconds > 0 ? stats.bytes / seconds / 1e6 : 0));
+        if constexpr (baybayin::StatsEnabled) {
+            // stage cycles add up over threads, so their seconds can add up to more than the run
+            const double cycle_seconds = elapsed > 0 ? seconds / static_cast<double>(elapsed) : 0;
+            constexpr std::array<std::string_view, baybayin::StageCount> stages{"consonants", "vowels",
+                                                                                "transliterate"};
+            json.append(",\"stages\":{");
+            for (size_t s = 0; s < stages.size(); ++s) {
+                json.append(s ? ",\"" : "\"").append(stages[s]).append("\":{\"cycles\":");
+                json.append(std::to_string(stats.cycles[s])).append(",\"seconds\":");
+                json.append(std::to_string(static_cast<double>(stats.cycles[s]) * cycle_seconds)).append("}");
+            }
+            json.append("}");
+            if (language != nullptr) {
+                const std::array passes{&language->consonants, &language->vowels};
+                constexpr std::array<std::string_view, baybayin::RulePassCount> names{"consonants", "vowels"};
+                json.append(",\"rules\":{");
+                for (size_t p = 0; p < passes.size(); ++p) {
+                    json.append(p ? ",\"" : "\"").append(names[p]).append("\":[");
+                    for (size_t r = 0; r < passes[p]->size(); ++r) {
+                        std::string label;
+                        append_rule_label(passes[p]->rule(r), label);
+                        json.append(r ? ",{\"rule\":" : "{\"rule\":");
+                        append_json_string(label, json);
+                        json.append(",\"hits\":").append(std::to_string(stats.rules[p][r])).append("}");
+                    }
+                    json.append("]");
+                }
+                json.append("}");
+            }
+            constexpr std::array<std::string_view, baybayin::GlyphClassCount> glyphs{"vowel", "syllable", "coda",
+                                                                                     "punctuation", "skipped"};
+            json.append(",\"glyphs\":{");
+            for (size_t g = 0; g < glyphs.size(); ++g) {
+                json.append(g ? ",\"" : "\"").append(glyphs[g]).append("\":");
+                json.append(std::to_string(stats.glyphs[g]));
+            }
+            json.append("}");
+        }
+        json.append("}");
+        out << json << std::endl;
+    }
+};
@@ -0,0 +1,39 @@
+#include <CLI/CLI.hpp>
+#include <baybayin-core/norm/lexicon.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "include/io.h"
+
+int
+main(const int argc, char **argv) {
+    CLI::App app{
+    "\nCompiles a word list into a lexicon for norm --lexicon: loanwords the rules get wrong, one per line followed "
+    "by a tab and how it normalizes. The lexicon is placed by a minimal perfect hash and mapped as it is, so norm "
+    "loads it without parsing.",
+    "baybayin-lexicon"};
+    app.option_defaults()->always_capture_default();
+
+    std::filesystem::path input_param;
+    app.add_option("-i,--input", input_param, "Word list, tab separated")->check(CLI::ExistingFile)->required();
+
+    std::filesystem::path output_param;
+    app.add_option("-o,--output", output_param, "Lexicon file to write")->required();
+
+    CLI11_PARSE(app, argc, argv);
+
+    std::stringstream text;
+    text << std::ifstream(input_param).rdbuf();
+    std::string image;
+    if (std::string error; !phil_norm::parse_lexicon(text.view(), image, error)) {
+        std::cerr << input_param.string() << ": " << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::ofstream output(output_param, std::ios::binary);
+    if (!output.write(image.data(), static_cast<std::streamsize>(image.size())) || !output.flush()) {
+        std::cerr << "failed to write output: " << std::strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
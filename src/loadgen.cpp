@@ -0,0 +1,143 @@
+#include <CLI/CLI.hpp>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <vector>
+#include "include/io.h"
+#include "include/protocol.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Sends count requests over one connection, keeping depth of them in flight, and records how long each took
+bool drive(const std::filesystem::path &path, const std::vector<std::string> &requests, const size_t first,
+           const size_t count, const size_t depth, std::vector<Clock::duration> &latencies) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    path.native().copy(address.sun_path, sizeof(address.sun_path) - 1);
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0) {
+        std::cerr << "failed to connect to " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    std::deque<Clock::time_point> in_flight;
+    std::string batch, block, carry;
+    size_t sent = 0, received = 0;
+    while (received < count) {
+        batch.clear();
+        for (; sent < count && in_flight.size() < depth; ++sent) {
+            batch.append(requests[(first + sent) % requests.size()]).push_back('\n');
+            in_flight.push_back(Clock::now());
+        }
+        if (!write_all(fd, batch) || !read_available(fd, block, carry)) {
+            std::cerr << "connection lost: " << std::strerror(errno) << std::endl;
+            ::close(fd);
+            return false;
+        }
+        const auto now = Clock::now();
+        for (size_t responses = std::ranges::count(block, '\n'); responses > 0; --responses) {
+            latencies.push_back(now - in_flight.front());
+            in_flight.pop_front();
+            ++received;
+        }
+    }
+    ::close(fd);
+    return true;
+}
+
+int main(const int argc, char **argv) {
+    CLI::App app{
+    "\nLoad generator for baybayin-server: replays requests over several connections and reports latency "
+    "percentiles and throughput.",
+    "baybayin-loadgen"};
+    app.option_defaults()->always_capture_default();
+
+    std::filesystem::path socket_param;
+    app.add_option("--socket", socket_param, "Unix domain socket the server listens on")->required();
+
+    std::filesystem::path input_param;
+    app.add_option("--input", input_param, "Text to send, a request a line, otherwise a built-in sample")
+       ->check(CLI::ExistingFile);
+
+    std::string tool_param = "tl";
+    app.add_option("--tool", tool_param)->check(CLI::IsMember({"tl", "norm"}));
+
+    bool normalize_param = false;
+    app.add_flag("--normalize", normalize_param, "Send tl requests with normalize set");
+
+    size_t connections_param = 4;
+    app.add_option("--connections", connections_param)->check(CLI::PositiveNumber);
+
+    size_t requests_param = 100000;
+    app.add_option("--requests", requests_param, "Requests to send in all")->check(CLI::PositiveNumber);
+
+    size_t depth_param = 1;
+    app.add_option("--depth", depth_param, "Requests each connection keeps in flight")->check(CLI::PositiveNumber);
+
+    CLI11_PARSE(app, argc, argv);
+
+    std::vector<std::string> texts;
+    if (!input_param.empty()) {
+        std::ifstream istream(input_param);
+        for (std::string line; std::getline(istream, line);) {
+            texts.push_back(std::move(line));
+        }
+    }
+    if (texts.empty()) {
+        texts = {"Ang pangalan ko ay Inday.", "Taga-Maynila ako at nag-aaral ng computer science.",
+                 "Kasi nga dilaw ang paborito kong kulay.", "Mga phone at laptop ang dala ko sa office.",
+                 "pagmamahal", "ang favorite ko ay ang chocolate cake ni Lola"};
+    }
+    std::vector<std::string> requests;
+    for (size_t i = 0; i < texts.size(); ++i) {
+        std::string request = "{\"id\":" + std::to_string(i) + ",\"tool\":\"" + tool_param + "\"";
+        if (normalize_param) {
+            request.append(",\"normalize\":true");
+        }
+        request.append(",\"text\":");
+        append_json_string(texts[i], request);
+        requests.push_back(request.append("}"));
+    }
+
+    std::vector<std::vector<Clock::duration>> latencies(connections_param);
+    std::vector<char> succeeded(connections_param);
+    const auto start = Clock::now();
+    {
+        std::vector<std::jthread> clients;
+        for (size_t c = 0; c < connections_param; ++c) {
+            const size_t first = requests_param * c / connections_param;
+            const size_t count = requests_param * (c + 1) / connections_param - first;
+            clients.emplace_back([&, c, first, count] {
+                latencies[c].reserve(count);
+                succeeded[c] = drive(socket_param, requests, first, count, depth_param, latencies[c]);
+            });
+        }
+    }
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    if (std::ranges::count(succeeded, 0) > 0) {
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Clock::duration> all;
+    for (const auto &connection : latencies) {
+        all.insert(all.end(), connection.begin(), connection.end());
+    }
+    std::ranges::sort(all);
+    const auto percentile = [&all](const double p) {
+        const auto index = std::min(all.size() - 1, static_cast<size_t>(p * static_cast<double>(all.size())));
+        return std::chrono::duration<double, std::micro>(all[index]).count();
+    };
+    std::cout << "requests:    " << all.size() << "\n"
+              << "connections: " << connections_param << " x depth " << depth_param << "\n"
+              << "throughput:  " << static_cast<double>(all.size()) / elapsed.count() << " requests/s\n"
+              << "latency p50: " << percentile(0.50) << " us\n"
+              << "latency p99: " << percentile(0.99) << " us\n"
+              << "latency max: " << percentile(1.0) << " us" << std::endl;
+    return EXIT_SUCCESS;
+}
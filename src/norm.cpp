@@ -1,30 +1,14 @@
 #include <CLI/CLI.hpp>
 #include <baybayin-core/norm.h>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
-#include "include/utils.h"
+#include <sstream>
+#include "include/io.h"
+#include "include/report.h"
 
 using namespace phil_norm;
 
-int
-normalize(std::istream &istream, std::ostream &ostream, const ForeignLanguage language,
-          const LatinOrthography orthography, const Diphthong diphthongs, const InitialCluster clusters
-) {
-    std::string line;
-    while (std::getline(istream, line)) {
-        ostream << normalizer(line, language, orthography, diphthongs, clusters) << std::endl;
-        if (ostream.bad()) {
-            std::cerr << "Error writing output: " << std::strerror(errno) << std::endl;
-            return EXIT_FAILURE;
-        }
-    }
-    if (istream.bad()) {
-        std::cerr << "Error reading input: " << std::strerror(errno) << std::endl;
-        return EXIT_FAILURE;
-    }
-    return EXIT_SUCCESS;
-}
-
 int
 main(const int argc, char **argv) {
     CLI::App app{
@@ -55,21 +39,77 @@ main(const int argc, char **argv) {
     std::string_view clusters_param = REFORMED;
     app.add_option("-c,--clusters", clusters_param)->check(CLI::IsMember({REFORMED, "traditional"}));
 
+    size_t threads_param = 1;
+    app.add_option("-t,--threads", threads_param,
+                   "Worker threads, more than one processes the input in blocks of lines")->check(CLI::PositiveNumber);
+
+    size_t cache_param = 0;
+    const auto cache_size = app.add_option("--cache-size", cache_param,
+                                           "Words each thread memoizes the normalization of, 0 for none");
+
+    std::filesystem::path rules_param;
+    app.add_option("--rules", rules_param,
+                   "Rule file to normalize with instead of the built-in rules of the language and orthography")
+       ->check(CLI::ExistingFile)->excludes(cache_size);
+
+    std::filesystem::path lexicon_param;
+    app.add_option("--lexicon", lexicon_param, "Lexicon built by baybayin-lexicon, words normalized as it has them")
+       ->check(CLI::ExistingFile);
+
+    bool stats_param = false;
+    app.add_flag("--stats", stats_param,
+                 "Print throughput to stderr as JSON, with stage times and rule hits in a BAYBAYIN_STATS build");
+
     CLI11_PARSE(app, argc, argv);
     const auto ortho = ortho_param == ABAKADA ? LatinOrthography::ABAKADA : LatinOrthography::ALPABETONG;
     const auto lang = lang_param == SPANISH ? ForeignLanguage::SPANISH : ForeignLanguage::ENGLISH;
     const auto diphthong = diphthongs_param == REFORMED ? Diphthong::REFORMED : Diphthong::TRADITIONAL;
     const auto clusters = clusters_param == REFORMED ? InitialCluster::REFORMED : InitialCluster::TRADITIONAL;
 
-    if (const auto istream = get_input_stream(input_param);
-        istream->good()) {
-        if (const auto ostream = get_output_stream(output_param);
-            ostream->good()) {
-            return normalize(*istream, *ostream, lang, ortho, diphthong, clusters);
-        }
-        std::cerr << "failed to write output: " << std::strerror(errno) << std::endl;
+    // mapped for the whole run, the lexicon is looked up in place
+    const MappedFile lexicon_file(lexicon_param, MADV_RANDOM);
+    Lexicon lexicon;
+    if (std::string error; !lexicon_param.empty() && !lexicon.load(lexicon_file.view(), error)) {
+        std::cerr << lexicon_param.string() << ": " << error << std::endl;
         return EXIT_FAILURE;
     }
-    std::cerr << "failed to read input: " << std::strerror(errno) << std::endl;
-    return EXIT_FAILURE;
+
+    Normalizer engine(lang, ortho, diphthong, clusters, lexicon);
+    Language language = builtin_language(lang, ortho);
+    if (!rules_param.empty()) {
+        std::stringstream text;
+        text << std::ifstream(rules_param).rdbuf();
+        language = {};
+        if (std::string error; !parse_language(text.view(), language, error)) {
+            std::cerr << rules_param.string() << ": " << error << std::endl;
+            return EXIT_FAILURE;
+        }
+        engine = Normalizer(language, clusters, lexicon);
+    }
+
+    const StatsReport report;
+    int status;
+    if (threads_param > 1) {
+        status = process_parallel(input_param, output_param, threads_param, [&] {
+            return [engine, cache = baybayin::WordCache(cache_param), stats_param](const std::string_view line,
+                                                                                   std::string &out) mutable {
+                if (stats_param) {
+                    count_input(line);
+                }
+                engine.normalize(line, out, cache);
+            };
+        });
+    } else {
+        baybayin::WordCache cache(cache_param);
+        status = process_input(input_param, output_param, [&](const std::string_view line, std::string &out) {
+            if (stats_param) {
+                count_input(line);
+            }
+            engine.normalize(line, out, cache);
+        });
+    }
+    if (stats_param) {
+        report.print(std::cerr, &language);
+    }
+    return status;
 }
@@ -0,0 +1,97 @@
+#include <CLI/CLI.hpp>
+#include <atomic>
+#include <baybayin-core/util/parallel.h>
+#include <csignal>
+#include <filesystem>
+#include <iostream>
+#include <list>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include "include/io.h"
+#include "include/protocol.h"
+
+using namespace baybayin;
+
+// Answers one stream of requests until it ends. Whatever has arrived while the workers were busy makes the next
+// batch, so a lone request goes straight through and a burst is spread over the pool.
+bool serve(LinePool &pool, const int input, const int output) {
+    OrderedBlocks blocks(2 * pool.size());
+    std::string carry;
+    return pool.run(blocks, [&](std::string &block) { return read_available(input, block, carry); },
+                    [&](const std::string &responses) { return write_all(output, responses); });
+}
+
+int serve_socket(LinePool &pool, const std::filesystem::path &path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.native().size() >= sizeof(address.sun_path)) {
+        std::cerr << "socket path too long: " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+    path.native().copy(address.sun_path, sizeof(address.sun_path) - 1);
+    const int listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    std::filesystem::remove(path);
+    if (listener < 0 || ::bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0 ||
+        ::listen(listener, SOMAXCONN) < 0) {
+        std::cerr << "failed to listen on " << path << ": " << std::strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+    struct Connection {
+        std::atomic<bool> done = false;
+        std::jthread thread;
+    };
+    // joined before the pool goes
+    std::list<Connection> connections;
+    while (true) {
+        const int client = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            std::cerr << "failed to accept: " << std::strerror(errno) << std::endl;
+            ::close(listener);
+            return EXIT_FAILURE;
+        }
+        std::erase_if(connections, [](const Connection &connection) { return connection.done.load(); });
+        Connection &connection = connections.emplace_back();
+        connection.thread = std::jthread([&pool, &connection, client] {
+            serve(pool, client, client);
+            ::close(client);
+            connection.done = true;
+        });
+    }
+}
+
+int main(const int argc, char **argv) {
+    CLI::App app{
+    "\nServes tl and norm over a long-running process: one JSON request a line in, one JSON response a line out, "
+    "in the same order.",
+    "baybayin-server"};
+    app.option_defaults()->always_capture_default();
+
+    std::filesystem::path socket_param;
+    app.add_option("--socket", socket_param, "Unix domain socket to listen on, otherwise stdin and stdout");
+
+    size_t threads_param = std::max(1u, std::thread::hardware_concurrency());
+    app.add_option("--threads", threads_param, "Worker threads, shared by all connections")
+       ->check(CLI::PositiveNumber);
+
+    CLI11_PARSE(app, argc, argv);
+
+    // a client hanging up fails its writes rather than ending the server
+    std::signal(SIGPIPE, SIG_IGN);
+    LinePool pool(threads_param, [] {
+        return [responder = Responder()](const std::string_view line, std::string &out) mutable {
+            responder.respond(line, out);
+        };
+    });
+    if (!socket_param.empty()) {
+        return serve_socket(pool, socket_param);
+    }
+    if (!serve(pool, STDIN_FILENO, STDOUT_FILENO)) {
+        std::cerr << "Error writing output: " << std::strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -1,25 +1,50 @@
+#include <array>
 #include <iostream>
 #include <filesystem>
 #include <CLI/CLI.hpp>
+#include <baybayin-core/pipeline.h>
 #include <baybayin-core/tl.h>
-#include "include/utils.h"
+#include "include/io.h"
+#include "include/report.h"
 
 using namespace baybayin;
 
-int transliterate(std::istream &istream, std::ostream &ostream, const Orthography &ortho) {
-    std::string line;
-    while (std::getline(istream, line)) {
-        ostream << latin_to_baybayin(line, ortho) << std::endl;
-        if (ostream.bad()) {
-            std::cerr << "Error writing output: " << std::strerror(errno) << std::endl;
-            return EXIT_FAILURE;
+// Reads input that cannot be mapped a buffer at a time, so memory stays bounded however long its lines are
+bool transliterate(std::istream &istream, BlockWriter &out, const Orthography &ortho, const bool stats) {
+    std::array<char, 1 << 16> buffer{};
+    StreamingTransliterator transliterator(ortho);
+    bool in_line = false;
+    while (true) {
+        istream.getline(buffer.data(), buffer.size());
+        const bool eol = istream.good();
+        const bool eof = istream.eof();
+        const auto count = static_cast<size_t>(istream.gcount()) - (eol ? 1 : 0);
+        if (istream.bad() || (eof && count == 0 && !in_line)) {
+            break;
+        }
+        if (!eol && !eof) {
+            istream.clear(); // the buffer filled up before the end of the line
+        }
+        if (stats) {
+            thread_stats().bytes += count + (eol ? 1 : 0);
+        }
+        transliterator.feed(std::string_view(buffer.data(), count), out.buffer());
+        in_line = !eol && !eof;
+        if (in_line) {
+            if (!out.flush_block()) {
+                return false;
+            }
+        } else {
+            transliterator.finish(out.buffer());
+            if (!out.end_line()) {
+                return false;
+            }
+        }
+        if (eof) {
+            break;
         }
     }
-    if (istream.bad()) {
-        std::cerr << "Error reading input: " << std::strerror(errno) << std::endl;
-        return EXIT_FAILURE;
-    }
-    return EXIT_SUCCESS;
+    return true;
 }
 
 int main(const int argc, char **argv) {
@@ -39,17 +64,104 @@ int main(const int argc, char **argv) {
     std::string_view ortho_param = REFORMED;
     app.add_option("--orthography", ortho_param)->check(CLI::IsMember({"traditional", REFORMED}));
 
+    bool reverse_param = false;
+    const auto reverse = app.add_flag("--reverse", reverse_param, "Read baybayin input back into latin");
+
+    bool normalize_param = false;
+    app.add_flag("--normalize", normalize_param, "Normalize raw latin input first, as norm would")->excludes(reverse);
+
+    // normalization settings, see norm
+    const char *ABAKADA = {"abakada"};
+    std::string_view latin_param = ABAKADA;
+    app.add_option("--latin-orthography", latin_param)->check(CLI::IsMember({ABAKADA, "alpabetong"}));
+
+    const char *SPANISH = {"spanish"};
+    std::string_view lang_param = SPANISH;
+    app.add_option("--language", lang_param)->check(CLI::IsMember({SPANISH, "english"}));
+
+    std::string_view diphthongs_param = REFORMED;
+    app.add_option("--diphthong", diphthongs_param)->check(CLI::IsMember({REFORMED, "traditional"}));
+
+    std::string_view clusters_param = REFORMED;
+    app.add_option("--clusters", clusters_param)->check(CLI::IsMember({REFORMED, "traditional"}));
+
+    size_t threads_param = 1;
+    app.add_option("--threads", threads_param, "Worker threads, more than one processes the input in blocks of lines")
+       ->check(CLI::PositiveNumber);
+
+    size_t cache_param = 0;
+    app.add_option("--cache-size", cache_param, "Words each thread memoizes the transliteration of, 0 for none");
+
+    bool stats_param = false;
+    app.add_flag("--stats", stats_param,
+                 "Print throughput to stderr as JSON, with stage times, rule hits and glyphs in a BAYBAYIN_STATS "
+                 "build");
+
     CLI11_PARSE(app, argc, argv);
 
     const auto ortho = ortho_param == REFORMED ? Orthography::Reformed : Orthography::Traditional;
 
-    if (const auto istream = get_input_stream(input_param); istream->good()) {
-        if (const auto ostream = get_output_stream(output_param); ostream->good()) {
-            return transliterate(*istream, *ostream, ortho);
+    const StatsReport report;
+    const phil_norm::Language *language = nullptr;
+    int status;
+    if (normalize_param) {
+        const auto lang = lang_param == SPANISH ? ForeignLanguage::SPANISH : ForeignLanguage::ENGLISH;
+        const auto latin = latin_param == ABAKADA ? LatinOrthography::ABAKADA : LatinOrthography::ALPABETONG;
+        language = &phil_norm::builtin_language(lang, latin);
+        NormalizingTransliterator pipeline(
+            lang, latin, diphthongs_param == REFORMED ? Diphthong::REFORMED : Diphthong::TRADITIONAL,
+            clusters_param == REFORMED ? InitialCluster::REFORMED : InitialCluster::TRADITIONAL, ortho);
+        if (threads_param > 1) {
+            status = process_parallel(input_param, output_param, threads_param, [&pipeline, cache_param, stats_param] {
+                return [pipeline, cache = WordCache(cache_param), stats_param](const std::string_view line,
+                                                                               std::string &out) mutable {
+                    if (stats_param) {
+                        count_input(line);
+                    }
+                    pipeline.transliterate(line, out, cache);
+                };
+            });
+        } else {
+            WordCache cache(cache_param);
+            status = process_input(input_param, output_param, [&](const std::string_view line, std::string &out) {
+                if (stats_param) {
+                    count_input(line);
+                }
+                pipeline.transliterate(line, out, cache);
+            });
+        }
+    } else if (reverse_param) {
+        const auto read_back = [stats_param](const std::string_view line, std::string &out) {
+            if (stats_param) {
+                count_input(line);
+            }
+            baybayin_to_latin(line, out);
+        };
+        if (threads_param > 1) {
+            status = process_parallel(input_param, output_param, threads_param, [&read_back] { return read_back; });
+        } else {
+            status = process_input(input_param, output_param, read_back);
         }
-        std::cerr << "failed to write output: " << std::strerror(errno) << std::endl;
-        return EXIT_FAILURE;
+    } else {
+        // each worker gets a copy, with a cache of its own
+        auto transliterate_line = [ortho, cache = WordCache(cache_param), stats_param](const std::string_view line,
+                                                                                       std::string &out) mutable {
+            if (stats_param) {
+                count_input(line);
+            }
+            latin_to_baybayin(line, out, cache, ortho);
+        };
+        if (threads_param > 1) {
+            status = process_parallel(input_param, output_param, threads_param, [&] { return transliterate_line; });
+        } else {
+            const auto transliterate_stream = [ortho, stats_param](std::istream &istream, BlockWriter &out) {
+                return transliterate(istream, out, ortho, stats_param);
+            };
+            status = process_input(input_param, output_param, transliterate_line, transliterate_stream);
+        }
+    }
+    if (stats_param) {
+        report.print(std::cerr, language);
     }
-    std::cerr << "failed to read input: " << std::strerror(errno) << std::endl;
-    return EXIT_FAILURE;
+    return status;
 }
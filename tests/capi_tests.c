@@ -0,0 +1,117 @@
+#include <baybayin-core/capi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* A C program against libbaybayin, so the header is checked as C and the library linked from C */
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            fprintf(stderr, "%s:%d: %s failed\n", __FILE__, __LINE__, #condition); \
+            return EXIT_FAILURE;                                                \
+        }                                                                       \
+    } while (0)
+
+#define CHECK_OUTPUT(output, size, expected) \
+    CHECK((size) == strlen(expected) && memcmp((output), (expected), (size)) == 0)
+
+static int
+test_config(void) {
+    baybayin_config config;
+    baybayin_engine *engine = NULL;
+    CHECK(baybayin_abi_version() == BAYBAYIN_ABI_VERSION);
+    baybayin_config_init(&config);
+    CHECK(config.size == sizeof(baybayin_config));
+    CHECK(config.language == BAYBAYIN_SPANISH && config.orthography == BAYBAYIN_REFORMED);
+    config.virama = 2;
+    CHECK(baybayin_engine_create(&config, &engine) == BAYBAYIN_INVALID_ARGUMENT);
+    config.virama = BAYBAYIN_PAMUDPOD;
+    config.orthography = -1;
+    CHECK(baybayin_engine_create(&config, &engine) == BAYBAYIN_INVALID_ARGUMENT);
+    config.orthography = BAYBAYIN_MODERN;
+    config.size = 0;
+    CHECK(baybayin_engine_create(&config, &engine) == BAYBAYIN_INVALID_ARGUMENT);
+    config.size = sizeof(baybayin_config);
+    CHECK(baybayin_engine_create(&config, NULL) == BAYBAYIN_INVALID_ARGUMENT);
+    CHECK(baybayin_engine_create(&config, &engine) == BAYBAYIN_OK && engine != NULL);
+    baybayin_engine_destroy(engine);
+    baybayin_engine_destroy(NULL);
+    return EXIT_SUCCESS;
+}
+
+static int
+test_single(baybayin_engine *engine) {
+    char output[256];
+    size_t size = 0;
+    const char *latin = "Caso llama";
+    CHECK(baybayin_normalize(engine, latin, strlen(latin), output, sizeof(output), &size) == BAYBAYIN_OK);
+    CHECK_OUTPUT(output, size, "kaso yama");
+    CHECK(baybayin_transliterate(engine, "plano", 5, output, sizeof(output), &size) == BAYBAYIN_OK);
+    CHECK_OUTPUT(output, size, "ᜉ᜔ᜎᜈᜓ");
+    CHECK(baybayin_normalize_transliterate(engine, "Plano", 5, output, sizeof(output), &size) == BAYBAYIN_OK);
+    CHECK_OUTPUT(output, size, "ᜉ᜔ᜎᜈᜓ");
+    CHECK(size <= baybayin_normalize_transliterate_bound(engine, 5));
+    CHECK(baybayin_transliterate(engine, "", 0, NULL, 0, &size) == BAYBAYIN_OK && size == 0);
+    CHECK(baybayin_transliterate(engine, NULL, 5, output, sizeof(output), &size) == BAYBAYIN_INVALID_ARGUMENT);
+    CHECK(baybayin_normalize(NULL, "plano", 5, output, sizeof(output), &size) == BAYBAYIN_INVALID_ARGUMENT);
+    return EXIT_SUCCESS;
+}
+
+static int
+test_buffer_too_small(baybayin_engine *engine) {
+    char output[256];
+    size_t size = 0;
+    CHECK(baybayin_transliterate(engine, "plano", 5, output, 4, &size) == BAYBAYIN_BUFFER_TOO_SMALL);
+    CHECK(size == strlen("ᜉ᜔ᜎᜈᜓ"));
+    CHECK(baybayin_transliterate(engine, "plano", 5, output, size, &size) == BAYBAYIN_OK);
+    CHECK_OUTPUT(output, size, "ᜉ᜔ᜎᜈᜓ");
+    CHECK(baybayin_normalize_transliterate(engine, "Plano", 5, NULL, 0, &size) == BAYBAYIN_BUFFER_TOO_SMALL);
+    CHECK(size == strlen("ᜉ᜔ᜎᜈᜓ"));
+    CHECK(baybayin_normalize(engine, "llama", 5, output, 2, &size) == BAYBAYIN_BUFFER_TOO_SMALL && size == 4);
+    return EXIT_SUCCESS;
+}
+
+static int
+test_batch(baybayin_engine *engine) {
+    const char *input = "Planollama";
+    const size_t input_offsets[] = {0, 5, 5, 10};
+    size_t output_offsets[4];
+    char output[256];
+    CHECK(baybayin_normalize_batch(engine, input, input_offsets, 3, output, sizeof(output), output_offsets) ==
+          BAYBAYIN_OK);
+    CHECK(output_offsets[0] == 0 && output_offsets[1] == 5 && output_offsets[2] == 5 && output_offsets[3] == 9);
+    CHECK_OUTPUT(output, output_offsets[3], "planoyama");
+    CHECK(baybayin_normalize_transliterate_batch(engine, input, input_offsets, 3, output, sizeof(output),
+                                                 output_offsets) == BAYBAYIN_OK);
+    CHECK_OUTPUT(output, output_offsets[1], "ᜉ᜔ᜎᜈᜓ");
+    CHECK(output_offsets[2] == output_offsets[1]);
+    CHECK_OUTPUT(output + output_offsets[2], output_offsets[3] - output_offsets[2], "ᜌᜋ");
+    CHECK(output_offsets[3] <= baybayin_normalize_transliterate_bound(engine, input_offsets[3]));
+    /* the first result fits and the last does not */
+    CHECK(baybayin_normalize_transliterate_batch(engine, input, input_offsets, 3, output, output_offsets[2] + 1,
+                                                 output_offsets) == BAYBAYIN_BUFFER_TOO_SMALL);
+    CHECK(output_offsets[1] == strlen("ᜉ᜔ᜎᜈᜓ") && output_offsets[2] == output_offsets[1]);
+    CHECK_OUTPUT(output, output_offsets[1], "ᜉ᜔ᜎᜈᜓ");
+    CHECK(baybayin_transliterate_batch(engine, input, input_offsets, 0, NULL, 0, output_offsets) == BAYBAYIN_OK);
+    CHECK(output_offsets[0] == 0);
+    return EXIT_SUCCESS;
+}
+
+int
+main(void) {
+    baybayin_config config;
+    baybayin_engine *engine = NULL;
+    int status;
+    if (test_config() != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    baybayin_config_init(&config);
+    if (baybayin_engine_create(&config, &engine) != BAYBAYIN_OK) {
+        return EXIT_FAILURE;
+    }
+    status = test_single(engine) || test_buffer_too_small(engine) || test_batch(engine) ? EXIT_FAILURE
+                                                                                         : EXIT_SUCCESS;
+    baybayin_engine_destroy(engine);
+    return status;
+}
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <baybayin-core/norm.h>
+#include <string>
+#include "include/corpus.h"
+
+static std::string
+generate(const uint64_t seed, const size_t lines) {
+    corpus::Generator generator(seed);
+    std::string out;
+    for (size_t l = 0; l < lines; ++l) {
+        generator.line(out);
+    }
+    return out;
+}
+
+TEST(Corpus, Deterministic) {
+    EXPECT_EQ(generate(1, 200), generate(1, 200));
+    EXPECT_NE(generate(1, 200), generate(2, 200));
+    // lines do not depend on how the output is split up
+    EXPECT_EQ(generate(7, 100) + generate(7, 200).substr(generate(7, 100).size()), generate(7, 200));
+}
+
+TEST(Corpus, Coverage) {
+    const std::string text = generate(1, 2000);
+    for (const std::string_view part : {"ch", "ck", "qu", "ll", "ph", "x", "z", "j", "f", "v", "ñ", "-", ",", "?",
+                                        "!", "\t", "  ", "\n\n"}) {
+        EXPECT_NE(text.find(part), std::string::npos) << part;
+    }
+    EXPECT_EQ(text.back(), '\n');
+}
+
+// The fused normalizer against the two pass reference, over generated text in every setting
+TEST(Corpus, FastNormalizer) {
+    const std::string text = generate(3, 2000);
+    for (const auto language : {ForeignLanguage::SPANISH, ForeignLanguage::ENGLISH}) {
+        for (const auto ortho : {LatinOrthography::ABAKADA, LatinOrthography::ALPABETONG}) {
+            for (const auto diphthongs : {Diphthong::TRADITIONAL, Diphthong::REFORMED}) {
+                for (const auto clusters : {InitialCluster::TRADITIONAL, InitialCluster::REFORMED}) {
+                    std::string out;
+                    phil_norm::fast_normalizer(text, out, language, ortho, diphthongs, clusters);
+                    EXPECT_EQ(out, phil_norm::normalizer(text, language, ortho, diphthongs, clusters));
+                }
+            }
+        }
+    }
+}
@@ -68,10 +68,12 @@ constexpr std::array TestVocabulary = std::to_array<Translation>({
     {"naiwan", "ᜈᜁᜏ", "ᜈᜁᜏᜈ᜔"},
     {"opo", "ᜂᜉᜓ", "ᜂᜉᜓ"},
     {"nang", "ᜈ", "ᜈᜅ᜔"},
-    {"manga", "ᜋᜅ","ᜋᜅ"}
+    {"manga", "ᜋᜅ","ᜋᜅ"},
+    {"ang", "ᜀ", "ᜀᜅ᜔"},
+    {"bangka", "ᜊᜃ", "ᜊᜅ᜔ᜃ"},
+    {"ngipin", "ᜅᜒᜉᜒ", "ᜅᜒᜉᜒᜈ᜔"}
 
-    // Initial consonant clusters
-    //{"plano", "ᜉᜒᜎᜈᜓ", "ᜉ᜔ᜎ 1q2ᜈᜓ"}
+    // Initial consonant clusters are broken up by the normalizer, see NormalizeToBaybayin.Clusters
 });
 
 constexpr TranslateTestCase TranslationTraditional (const Translation& l) {
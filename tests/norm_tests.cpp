@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <random>
+#include <set>
 #include <baybayin-core/norm.h>
 
 TEST(norm, norm) {
@@ -8,6 +10,381 @@ TEST(norm, norm) {
         phil_norm::LatinOrthography::ABAKADA,
         phil_norm::Diphthong::REFORMED,
         phil_norm::InitialCluster::REFORMED);
-    // TODO: remove this when ready to automate tests
-    std::cout << result << std::endl;
-}
\ No newline at end of file
+    EXPECT_EQ(result, "krist kots sinema kan tsans");
+}
+
+TEST(norm, batch) {
+    const std::vector<std::string_view> column = {"christ coche", "", "cinema  can ", "xerox chance"};
+    auto batch = phil_norm::normalizer_batch(column,
+        phil_norm::ForeignLanguage::ENGLISH,
+        phil_norm::LatinOrthography::ABAKADA,
+        phil_norm::Diphthong::REFORMED,
+        phil_norm::InitialCluster::REFORMED);
+    ASSERT_EQ(batch.size(), column.size());
+    // sized for the worst case, so the arena never moves, and reused with its scratch buffers
+    EXPECT_GE(batch.data.capacity(), baybayin::total_size(column) * phil_norm::normalize_growth(
+        phil_norm::ForeignLanguage::ENGLISH, phil_norm::LatinOrthography::ABAKADA, phil_norm::InitialCluster::REFORMED));
+    const char *const arena = batch.data.data();
+    phil_norm::normalizer_batch(column, batch,
+        phil_norm::ForeignLanguage::ENGLISH,
+        phil_norm::LatinOrthography::ABAKADA,
+        phil_norm::Diphthong::REFORMED,
+        phil_norm::InitialCluster::REFORMED);
+    EXPECT_EQ(batch.data.data(), arena);
+    ASSERT_EQ(batch.size(), column.size());
+    for (size_t i = 0; i < column.size(); ++i) {
+        EXPECT_EQ(batch[i], phil_norm::normalizer(column[i],
+            phil_norm::ForeignLanguage::ENGLISH,
+            phil_norm::LatinOrthography::ABAKADA,
+            phil_norm::Diphthong::REFORMED,
+            phil_norm::InitialCluster::REFORMED)) << column[i];
+    }
+}
+
+TEST(norm, word_boundaries) {
+    // punctuation ends and starts words just as whitespace does, digits and ñ do not
+    const std::vector<std::pair<std::string_view, std::string_view>> cases = {
+        {"(xerox)", "(seroks)"},
+        {"tax-xerox", "taks-seroks"},
+        {"mga, bata", "manga, bata"},
+        {"\"ng\" bata", "\"nang\" bata"},
+        {"ang mga.", "ang manga."},
+        {"nice. time", "nis. tim"},
+        {"mga2 ng\xC3\xB1", "mga2 ngny"},
+    };
+    for (const auto &[latin, normalized] : cases) {
+        EXPECT_EQ(phil_norm::normalizer(latin,
+            phil_norm::ForeignLanguage::ENGLISH,
+            phil_norm::LatinOrthography::ABAKADA,
+            phil_norm::Diphthong::REFORMED,
+            phil_norm::InitialCluster::REFORMED), normalized);
+        std::string fast;
+        phil_norm::fast_normalizer(latin, fast,
+            phil_norm::ForeignLanguage::ENGLISH,
+            phil_norm::LatinOrthography::ABAKADA,
+            phil_norm::Diphthong::REFORMED,
+            phil_norm::InitialCluster::REFORMED);
+        EXPECT_EQ(fast, normalized);
+    }
+}
+
+TEST(norm, fast_normalizer) {
+    // the letters with rules in either case, ñ, and lengths crossing scan blocks
+    constexpr std::string_view alphabet = "aeioubkdghlmnprstwyMGAEOcxqjfvzCHXQ  \t,.-\xC3\xB1\x91";
+    std::mt19937 random(31);
+    std::string fast;
+    for (size_t round = 0; round < 2000; ++round) {
+        std::string latin(random() % (round % 8 ? 40 : 400), ' ');
+        for (auto &c : latin) {
+            c = alphabet[random() % alphabet.size()];
+        }
+        for (const auto language : {phil_norm::ForeignLanguage::SPANISH, phil_norm::ForeignLanguage::ENGLISH}) {
+            for (const auto orthography : {phil_norm::LatinOrthography::ABAKADA,
+                                           phil_norm::LatinOrthography::ALPABETONG}) {
+                for (const auto diphthongs : {phil_norm::Diphthong::TRADITIONAL, phil_norm::Diphthong::REFORMED}) {
+                    for (const auto clusters : {phil_norm::InitialCluster::TRADITIONAL,
+                                                phil_norm::InitialCluster::REFORMED}) {
+                        fast.clear();
+                        phil_norm::fast_normalizer(latin, fast, language, orthography, diphthongs, clusters);
+                        EXPECT_EQ(fast, phil_norm::normalizer(latin, language, orthography, diphthongs, clusters))
+                            << latin;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(norm, clusters) {
+    const std::vector<std::pair<std::string_view, std::string_view>> cases = {
+        {"plano", "palano"},
+        {"Tren, klima at prito", "teren, kilima at pirito"},
+        {"kwento ng dyos", "kuwento nang diyos"},
+        // only at the start of a word, and only before a vowel
+        {"templo sky bla.bla", "templo sky bala.bala"},
+        {"mga ngyon", "manga ngyon"},
+    };
+    phil_norm::Normalizer engine(phil_norm::ForeignLanguage::ENGLISH, phil_norm::LatinOrthography::ABAKADA,
+                                 phil_norm::Diphthong::REFORMED, phil_norm::InitialCluster::TRADITIONAL);
+    for (const auto &[latin, normalized] : cases) {
+        EXPECT_EQ(phil_norm::normalizer(latin, phil_norm::ForeignLanguage::ENGLISH,
+                                        phil_norm::LatinOrthography::ABAKADA, phil_norm::Diphthong::REFORMED,
+                                        phil_norm::InitialCluster::TRADITIONAL), normalized);
+        EXPECT_EQ(engine.normalize(latin), normalized);
+    }
+    EXPECT_EQ(phil_norm::normalizer("plano", phil_norm::ForeignLanguage::ENGLISH, phil_norm::LatinOrthography::ABAKADA,
+                                    phil_norm::Diphthong::REFORMED, phil_norm::InitialCluster::REFORMED), "plano");
+}
+
+TEST(norm, dispatch) {
+    // every configuration has its own entry, running the rules it names
+    std::set<size_t> indices;
+    std::string dispatched, direct, stage;
+    for (const auto language : {phil_norm::ForeignLanguage::SPANISH, phil_norm::ForeignLanguage::ENGLISH}) {
+        for (const auto orthography : {phil_norm::LatinOrthography::ABAKADA,
+                                       phil_norm::LatinOrthography::ALPABETONG}) {
+            for (const auto clusters : {phil_norm::InitialCluster::TRADITIONAL,
+                                        phil_norm::InitialCluster::REFORMED}) {
+                indices.insert(phil_norm::configuration_index(language, orthography, clusters));
+                const std::string_view latin = "Plano ng xerox, chocolate phone";
+                dispatched.clear();
+                direct.clear();
+                fast_normalize_dispatch(latin, dispatched, stage, language, orthography,
+                                        phil_norm::Diphthong::REFORMED, clusters);
+                const auto &rules = phil_norm::builtin_language(language, orthography);
+                if (clusters == phil_norm::InitialCluster::TRADITIONAL) {
+                    fast_normalize<phil_norm::InitialCluster::TRADITIONAL>(latin, direct, stage, rules);
+                } else {
+                    fast_normalize<phil_norm::InitialCluster::REFORMED>(latin, direct, stage, rules);
+                }
+                EXPECT_EQ(dispatched, direct);
+            }
+        }
+    }
+    EXPECT_EQ(indices.size(), phil_norm::ConfigurationCount);
+    EXPECT_EQ(*indices.rbegin(), phil_norm::ConfigurationCount - 1);
+}
+
+TEST(norm, Normalizer) {
+    phil_norm::Normalizer engine(phil_norm::ForeignLanguage::ENGLISH, phil_norm::LatinOrthography::ABAKADA,
+                                 phil_norm::Diphthong::REFORMED, phil_norm::InitialCluster::REFORMED);
+    const std::string_view first = engine.normalize("christ coche cinema can chance");
+    EXPECT_EQ(first, phil_norm::normalizer("christ coche cinema can chance", phil_norm::ForeignLanguage::ENGLISH,
+                                           phil_norm::LatinOrthography::ABAKADA, phil_norm::Diphthong::REFORMED,
+                                           phil_norm::InitialCluster::REFORMED));
+    // shorter input reuses the same storage
+    const std::string_view second = engine.normalize("mga xerox");
+    EXPECT_EQ(second.data(), first.data());
+    EXPECT_EQ(second, phil_norm::normalizer("mga xerox", phil_norm::ForeignLanguage::ENGLISH,
+                                            phil_norm::LatinOrthography::ABAKADA, phil_norm::Diphthong::REFORMED,
+                                            phil_norm::InitialCluster::REFORMED));
+    EXPECT_EQ(engine.normalize(""), "");
+}
+
+TEST(norm, fold_latin) {
+    std::string folded;
+    const std::string_view ascii = "plain ASCII, left where it is";
+    EXPECT_EQ(baybayin::fold_latin(ascii, folded).data(), ascii.data());
+    const std::vector<std::pair<std::string_view, std::string_view>> cases = {
+        {"C\u00e1diz az\u00facar ping\u00fcino \u00c9L", "Cadiz azucar pinguino EL"},
+        {"\u00c0\u00c5\u00c7\u00d8\u00dd\u00ff", "AACOYy"},
+        {"\u0141\u00f3d\u017a \u0160koda \u0130stanbul \u0152uvre stra\u00dfe", "Lodz Skoda Istanbul OEuvre strasse"},
+        {"\u00d1o\u00f1o", "\u00d1o\u00f1o"},
+        {"\u00bfQu\u00e9?\u00a0\u00a1S\u00ed!", "Que? Si!"},
+        {"\u201cs\u00ed\u201d \u2018no\u2019 \u2013 \u2014 ya\u2026", "\"si\" 'no' - - ya..."},
+        {"bata \U0001F600 \u00d7 \u2122", "bata \U0001F600 \u00d7 \u2122"},
+        // invalid UTF-8 is copied as written
+        {"a\xC3 \xA1" "b\xE2\x80", "a\xC3 \xA1" "b\xE2\x80"},
+    };
+    for (const auto &[text, expected] : cases) {
+        EXPECT_EQ(baybayin::fold_latin(text, folded), expected) << text;
+        EXPECT_LE(folded.size(), text.size()) << text;
+    }
+}
+
+TEST(norm, accents) {
+    const std::vector<std::pair<std::string_view, std::string_view>> cases = {
+        {"Az\u00facar de C\u00e1diz", "asukar de kadis"},
+        {"la canci\u00f3n del a\u00f1o", "la kansion del anyo"},
+        {"\u201cC\u00e1llate\u201d \u2014 dijo", "\"kayate\" - diho"},
+    };
+    for (const auto &[latin, normalized] : cases) {
+        EXPECT_EQ(phil_norm::normalizer(latin, phil_norm::ForeignLanguage::SPANISH,
+                                        phil_norm::LatinOrthography::ABAKADA, phil_norm::Diphthong::REFORMED,
+                                        phil_norm::InitialCluster::REFORMED), normalized) << latin;
+        EXPECT_EQ(phil_norm::fast_normalizer(latin, phil_norm::ForeignLanguage::SPANISH,
+                                             phil_norm::LatinOrthography::ABAKADA, phil_norm::Diphthong::REFORMED,
+                                             phil_norm::InitialCluster::REFORMED), normalized) << latin;
+    }
+    phil_norm::Normalizer engine(phil_norm::ForeignLanguage::SPANISH, phil_norm::LatinOrthography::ABAKADA,
+                                 phil_norm::Diphthong::REFORMED, phil_norm::InitialCluster::REFORMED);
+    baybayin::WordCache cache(64);
+    for (const auto &[latin, normalized] : cases) {
+        EXPECT_EQ(engine.normalize(latin), normalized);
+        std::string cached;
+        engine.normalize(latin, cached, cache);
+        EXPECT_EQ(cached, normalized);
+    }
+}
+
+TEST(norm, rules) {
+    const std::vector<std::tuple<phil_norm::ForeignLanguage, phil_norm::LatinOrthography, std::string_view,
+                                 std::string_view>> cases = {
+        {phil_norm::ForeignLanguage::SPANISH, phil_norm::LatinOrthography::ABAKADA, "calle queso chico ocho",
+         "kaye keso tsiko otso"},
+        {phil_norm::ForeignLanguage::SPANISH, phil_norm::LatinOrthography::ABAKADA, "CaLLe Mga q", "kaye manga k"},
+        {phil_norm::ForeignLanguage::SPANISH, phil_norm::LatinOrthography::ALPABETONG, "calle \xC3\x91o\xC3\xB1o",
+         "calle nyonyo"},
+        {phil_norm::ForeignLanguage::ENGLISH, phil_norm::LatinOrthography::ABAKADA, "quick phase boat see",
+         "kwik peys bot si"},
+        {phil_norm::ForeignLanguage::ENGLISH, phil_norm::LatinOrthography::ABAKADA, "CHRIST XENON", "krist senon"},
+        {phil_norm::ForeignLanguage::ENGLISH, phil_norm::LatinOrthography::ALPABETONG, "PHone zero", "fone zero"},
+    };
+    for (const auto &[language, orthography, latin, normalized] : cases) {
+        EXPECT_EQ(phil_norm::normalizer(latin, language, orthography, phil_norm::Diphthong::REFORMED,
+                                        phil_norm::InitialCluster::REFORMED), normalized);
+    }
+}
+
+TEST(norm, parse_language) {
+    phil_norm::Language language;
+    std::string error;
+    EXPECT_TRUE(phil_norm::parse_language("# pass before pattern after replacement\n"
+                                          "\n"
+                                          "consonant  ^   k   -   c   # a comment\n"
+                                          "consonant  V   s   V   z\n"
+                                          "vowel      C   i   V   y\n"
+                                          "vowel      -   ou  $   u\n", language, error));
+    EXPECT_EQ(language.consonants.reach(), 1u);
+    EXPECT_EQ(language.vowels.reach(), 2u);
+    EXPECT_EQ(language.vowels.behind(), 1u);
+    std::string consonants, normalized;
+    consonant_normalize("Kasa kiosk nou", consonants, language.consonants);
+    vowel_normalize(consonants, normalized, language.vowels);
+    EXPECT_EQ(normalized, "caza cyosk nu");
+
+    for (const auto text : {"consonant ^ k\n", "vowel - A - e\n", "syllable - a - e\n", "vowel a$ a - e\n",
+                            "vowel - a ^ e\n", "vowel - abcdefghi - e\n"}) {
+        phil_norm::Language rejected;
+        EXPECT_FALSE(phil_norm::parse_language(text, rejected, error)) << text;
+        EXPECT_EQ(error, "invalid rule on line 1");
+    }
+    EXPECT_FALSE(phil_norm::parse_language("vowel - a - e\nvowel\n", language, error));
+    EXPECT_EQ(error, "invalid rule on line 2");
+}
+
+TEST(norm, custom_rules) {
+    // contexts reaching back and ahead of the blocks and windows the fused engine works in
+    phil_norm::Language language;
+    std::string error;
+    ASSERT_TRUE(phil_norm::parse_language("consonant ^ k - c\n"
+                                          "consonant V s V z\n"
+                                          "consonant - th . t\n"
+                                          "consonant - n g$ ng\n"
+                                          "vowel C i V y\n"
+                                          "vowel ^ u - wu\n"
+                                          "vowel - ou $ u\n"
+                                          "vowel .CV e CC ee\n"
+                                          "vowel - a - aa\n", language, error)) << error;
+    constexpr std::string_view alphabet = "aeiouksthngdlyKSTHOU  \t,.-";
+    std::mt19937 random(7);
+    phil_norm::Normalizer engine(language, phil_norm::InitialCluster::REFORMED);
+    std::string fast;
+    for (size_t round = 0; round < 1000; ++round) {
+        std::string latin(random() % (round % 8 ? 40 : 600), ' ');
+        for (auto &c : latin) {
+            c = alphabet[random() % alphabet.size()];
+        }
+        std::string consonants, normalized;
+        consonant_normalize(latin, consonants, language.consonants);
+        vowel_normalize(consonants, normalized, language.vowels);
+        fast.clear();
+        engine.normalize(latin, fast);
+        EXPECT_EQ(fast, normalized) << latin;
+    }
+}
+
+TEST(Lexicon, Build) {
+    std::string image, error;
+    ASSERT_TRUE(phil_norm::parse_lexicon("# loanwords\r\nchrist\tkrayst\r\n\nCoche\tkotse\n", image, error)) << error;
+    phil_norm::Lexicon lexicon;
+    ASSERT_TRUE(lexicon.load(image, error)) << error;
+    EXPECT_EQ(lexicon.size(), 2u);
+    std::string_view value;
+    EXPECT_TRUE(lexicon.find("CHRIST", value));
+    EXPECT_EQ(value, "krayst");
+    EXPECT_TRUE(lexicon.find("coche", value));
+    EXPECT_EQ(value, "kotse");
+    EXPECT_FALSE(lexicon.find("chris", value));
+    EXPECT_FALSE(lexicon.find(std::string(100, 'a'), value));
+    // folded as the input is
+    ASSERT_TRUE(phil_norm::parse_lexicon("caf\u00e9\tkapi\n", image, error)) << error;
+    ASSERT_TRUE(lexicon.load(image, error)) << error;
+    EXPECT_TRUE(lexicon.find("CAFE", value));
+    EXPECT_EQ(value, "kapi");
+
+    EXPECT_FALSE(phil_norm::parse_lexicon("christ krayst\n", image, error));
+    EXPECT_EQ(error, "invalid entry on line 1");
+    EXPECT_FALSE(phil_norm::parse_lexicon("christ\tkrayst\nCHRIST\tkrist\n", image, error));
+    EXPECT_EQ(error, "duplicate entry for \"CHRIST\"");
+    for (const auto text : {"two words\tx\n", "christ\t\n", "\tx\n", "a-b\tx\n"}) {
+        EXPECT_FALSE(phil_norm::parse_lexicon(text, image, error)) << text;
+        EXPECT_TRUE(error.starts_with("invalid entry for")) << text;
+    }
+
+    ASSERT_TRUE(phil_norm::parse_lexicon("", image, error));
+    ASSERT_TRUE(lexicon.load(image, error));
+    EXPECT_TRUE(lexicon.empty());
+    EXPECT_FALSE(lexicon.find("christ", value));
+    EXPECT_FALSE(lexicon.load("not a lexicon at all, not even close", error));
+    EXPECT_EQ(error, "not a lexicon");
+    ASSERT_TRUE(phil_norm::parse_lexicon("christ\tkrayst\n", image, error));
+    image.pop_back();
+    EXPECT_FALSE(lexicon.load(image, error));
+    EXPECT_EQ(error, "truncated lexicon");
+}
+
+TEST(Lexicon, PerfectHash) {
+    std::mt19937 random(3);
+    std::vector<std::string> words;
+    std::set<std::string> seen;
+    while (words.size() < 5000) {
+        std::string word(1 + random() % 12, ' ');
+        for (auto &c : word) {
+            c = static_cast<char>('a' + random() % 26);
+        }
+        if (seen.insert(word).second) {
+            words.push_back(word);
+        }
+    }
+    std::vector<std::pair<std::string_view, std::string_view>> entries;
+    for (const auto &word : words) {
+        entries.emplace_back(word, std::string_view(word).substr(0, 1));
+    }
+    std::string image, error;
+    ASSERT_TRUE(phil_norm::build_lexicon(entries, image, error)) << error;
+    phil_norm::Lexicon lexicon;
+    ASSERT_TRUE(lexicon.load(image, error)) << error;
+    std::string_view value;
+    for (const auto &word : words) {
+        ASSERT_TRUE(lexicon.find(word, value)) << word;
+        EXPECT_EQ(value, word.substr(0, 1));
+        if (!seen.contains(word + "q")) {
+            EXPECT_FALSE(lexicon.find(word + "q", value)) << word;
+        }
+    }
+}
+
+TEST(Lexicon, Normalizer) {
+    // digits pass the rules untouched, so a lexicon word normalizes as its value written in its place would
+    std::string image, error;
+    ASSERT_TRUE(phil_norm::parse_lexicon("christ\t1\ncoche\t22\nmga\t333\n", image, error));
+    phil_norm::Lexicon lexicon;
+    ASSERT_TRUE(lexicon.load(image, error));
+    const std::vector<std::pair<std::string_view, std::string_view>> words = {
+        {"Christ", "1"}, {"coche", "22"}, {"MGA", "333"}, {"cinema", "cinema"}, {"ng", "ng"}, {"xerox", "xerox"},
+        {"the", "the"}, {"quick", "quick"}};
+    constexpr std::string_view separators[] = {" ", "  ", ", ", "-", "\t", ".", "(", ")"};
+    std::mt19937 random(11);
+    baybayin::WordCache cache(256);
+    for (const auto language : {phil_norm::ForeignLanguage::SPANISH, phil_norm::ForeignLanguage::ENGLISH}) {
+        phil_norm::Normalizer engine(language, phil_norm::LatinOrthography::ABAKADA, phil_norm::Diphthong::REFORMED,
+                                     phil_norm::InitialCluster::REFORMED, lexicon);
+        for (size_t round = 0; round < 500; ++round) {
+            std::string latin, replaced;
+            for (size_t n = random() % (round % 8 ? 8 : 80); n > 0; --n) {
+                const auto &[word, value] = words[random() % words.size()];
+                const auto separator = separators[random() % std::size(separators)];
+                latin.append(separator).append(word);
+                replaced.append(separator).append(value);
+            }
+            const auto expected = phil_norm::normalizer(replaced, language, phil_norm::LatinOrthography::ABAKADA,
+                                                        phil_norm::Diphthong::REFORMED,
+                                                        phil_norm::InitialCluster::REFORMED);
+            EXPECT_EQ(engine.normalize(latin), expected) << latin;
+            std::string cached;
+            engine.normalize(latin, cached, cache);
+            EXPECT_EQ(cached, expected) << latin;
+        }
+    }
+}
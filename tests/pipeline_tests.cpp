@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <memory_resource>
+#include <random>
+#include <baybayin-core/pipeline.h>
+
+using namespace baybayin;
+
+// Passes allocations through to upstream, counting them
+class CountingResource : public std::pmr::memory_resource {
+    std::pmr::memory_resource *upstream_;
+
+public:
+    size_t allocations = 0;
+
+    explicit CountingResource(std::pmr::memory_resource *upstream) : upstream_(upstream) {
+    }
+
+private:
+    void *
+    do_allocate(const size_t bytes, const size_t alignment) override {
+        allocations++;
+        return upstream_->allocate(bytes, alignment);
+    }
+
+    void
+    do_deallocate(void *memory, const size_t bytes, const size_t alignment) override {
+        upstream_->deallocate(memory, bytes, alignment);
+    }
+
+    [[nodiscard]] bool
+    do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST(NormalizeToBaybayin, MatchesTwoSteps) {
+    // long enough inputs to cross windows, with the letters the normalizer rewrites
+    constexpr std::string_view alphabet = "aeioubkdghlmnprstwyMGAcxqjfvzCHQ  \t,.\xC3\xB1";
+    std::mt19937 random(23);
+    for (size_t round = 0; round < 500; ++round) {
+        std::string latin(random() % (round % 4 ? 40 : 1000), ' ');
+        for (auto &c : latin) {
+            c = alphabet[random() % alphabet.size()];
+        }
+        for (const auto language : {ForeignLanguage::SPANISH, ForeignLanguage::ENGLISH}) {
+            for (const auto orthography : {LatinOrthography::ABAKADA, LatinOrthography::ALPABETONG}) {
+                for (const auto diphthongs : {Diphthong::TRADITIONAL, Diphthong::REFORMED}) {
+                    for (const auto clusters : {InitialCluster::TRADITIONAL, InitialCluster::REFORMED}) {
+                        const auto normalized = phil_norm::normalizer(latin, language, orthography, diphthongs,
+                                                                      clusters);
+                        for (const auto ortho : {Orthography::Traditional, Orthography::Reformed}) {
+                            EXPECT_EQ(normalize_to_baybayin(latin, language, orthography, diphthongs, clusters, ortho),
+                                      latin_to_baybayin(normalized, ortho)) << "\"" << latin << "\"";
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Words from a small vocabulary so they repeat, with the whitespace layouts and words the consonant pass drops
+TEST(NormalizeToBaybayin, Cached) {
+    constexpr std::array words{"mga", "ng", "MGA", "Ng", "bata", "CHocolate", "quezo", "xerox", "phone", "ang",
+                               "papel", "\xC3\xB1o\xC3\xB1o", "\xC3", "-", "e", "llama", "cielo", "box,"};
+    constexpr std::array spaces{" ", " ", "  ", "\t", " \n "};
+    std::mt19937 random(31);
+    std::vector<std::string> lines{"", " ", "  mga  bata ", "\xC3 mga ng \xC3  e  papel", "l", "a \xC3 \xC3 b  "};
+    for (size_t line = 0; line < 60; ++line) {
+        std::string text(random() % 3 ? "" : " ");
+        for (size_t word = random() % 10; word > 0; --word) {
+            text.append(words[random() % words.size()]).append(spaces[random() % spaces.size()]);
+        }
+        lines.push_back(random() % 2 ? text : text + words[random() % words.size()]);
+    }
+    for (const auto language : {ForeignLanguage::SPANISH, ForeignLanguage::ENGLISH}) {
+        for (const auto orthography : {LatinOrthography::ABAKADA, LatinOrthography::ALPABETONG}) {
+            for (const auto diphthongs : {Diphthong::TRADITIONAL, Diphthong::REFORMED}) {
+                for (const auto clusters : {InitialCluster::TRADITIONAL, InitialCluster::REFORMED}) {
+                    // both engines share one cache
+                    WordCache cache(64);
+                    Normalizer normalizer(language, orthography, diphthongs, clusters);
+                    NormalizingTransliterator pipeline(language, orthography, diphthongs, clusters);
+                    for (size_t pass = 0; pass < 2; ++pass) {
+                        for (const auto &line : lines) {
+                            std::string normalized, transliterated, expected;
+                            normalizer.normalize(line, normalized, cache);
+                            EXPECT_EQ(normalized, phil_norm::normalizer(line, language, orthography, diphthongs,
+                                                                        clusters)) << "\"" << line << "\"";
+                            pipeline.transliterate(line, transliterated, cache);
+                            pipeline.transliterate(line, expected);
+                            EXPECT_EQ(std::string_view(transliterated), expected) << "\"" << line << "\"";
+                        }
+                    }
+                    EXPECT_GT(cache.hits(), cache.misses());
+                }
+            }
+        }
+    }
+}
+
+TEST(NormalizeToBaybayin, Clusters) {
+    EXPECT_EQ(normalize_to_baybayin("plano", ForeignLanguage::SPANISH, LatinOrthography::ABAKADA,
+                                    Diphthong::REFORMED, InitialCluster::TRADITIONAL, Orthography::Traditional),
+              "ᜉᜎᜈᜓ");
+    EXPECT_EQ(normalize_to_baybayin("plano", ForeignLanguage::SPANISH, LatinOrthography::ABAKADA,
+                                    Diphthong::REFORMED, InitialCluster::REFORMED), "ᜉ᜔ᜎᜈᜓ");
+}
+
+TEST(NormalizeToBaybayin, Accents) {
+    EXPECT_EQ(normalize_to_baybayin("Az\u00facar de C\u00e1diz", ForeignLanguage::SPANISH, LatinOrthography::ABAKADA,
+                                    Diphthong::REFORMED, InitialCluster::REFORMED),
+              latin_to_baybayin("asukar de kadis"));
+    NormalizingTransliterator pipeline(ForeignLanguage::SPANISH, LatinOrthography::ABAKADA, Diphthong::REFORMED,
+                                       InitialCluster::REFORMED);
+    std::string out;
+    pipeline.transliterate("la canci\u00f3n del a\u00f1o", out);
+    EXPECT_EQ(out, latin_to_baybayin("la kansion del anyo"));
+    WordCache cache(64);
+    std::string cached;
+    pipeline.transliterate("la canci\u00f3n del a\u00f1o", cached, cache);
+    EXPECT_EQ(cached, out);
+}
+
+TEST(NormalizeToBaybayin, Reused) {
+    NormalizingTransliterator pipeline(ForeignLanguage::ENGLISH, LatinOrthography::ABAKADA, Diphthong::REFORMED,
+                                       InitialCluster::REFORMED);
+    std::string out;
+    pipeline.transliterate("  mga  bata ", out);
+    EXPECT_EQ(out, latin_to_baybayin("manga bata"));
+    out.clear();
+    pipeline.transliterate("ng phone", out);
+    EXPECT_EQ(out, latin_to_baybayin(phil_norm::normalizer("ng phone", ForeignLanguage::ENGLISH,
+                                                           LatinOrthography::ABAKADA, Diphthong::REFORMED,
+                                                           InitialCluster::REFORMED)));
+}
+
+TEST(NormalizeToBaybayin, MemoryResource) {
+    // enough text for every buffer to outgrow its inline storage and the pipeline to cross windows
+    std::string latin;
+    for (size_t i = 0; i < 40; ++i) {
+        latin.append("  Mga chocolate ng xerox, plano at quezo phone\t");
+    }
+    const auto normalized = phil_norm::normalizer(latin, ForeignLanguage::ENGLISH, LatinOrthography::ABAKADA,
+                                                  Diphthong::REFORMED, InitialCluster::TRADITIONAL);
+    const auto expected = latin_to_baybayin(normalized);
+    // an arena that cannot fall back on the heap
+    std::array<std::byte, 1 << 16> buffer;
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+    CountingResource resource(&arena);
+    // a buffer that forgot its allocator would come from the default resource
+    CountingResource fallback(std::pmr::new_delete_resource());
+    std::pmr::memory_resource *const previous = std::pmr::set_default_resource(&fallback);
+    const auto two_pass = phil_norm::normalizer(latin, &resource, ForeignLanguage::ENGLISH, LatinOrthography::ABAKADA,
+                                                Diphthong::REFORMED, InitialCluster::TRADITIONAL);
+    const auto one_pass = phil_norm::fast_normalizer(latin, &resource, ForeignLanguage::ENGLISH,
+                                                     LatinOrthography::ABAKADA, Diphthong::REFORMED,
+                                                     InitialCluster::TRADITIONAL);
+    const auto transliterated = latin_to_baybayin(two_pass, &resource);
+    const auto fused = normalize_to_baybayin(latin, &resource, ForeignLanguage::ENGLISH, LatinOrthography::ABAKADA,
+                                             Diphthong::REFORMED, InitialCluster::TRADITIONAL);
+    std::pmr::string read(&resource);
+    baybayin_to_latin(fused, read);
+    std::pmr::set_default_resource(previous);
+    EXPECT_EQ(fallback.allocations, 0u);
+    EXPECT_GE(resource.allocations, 5u);
+    EXPECT_EQ(std::string_view(two_pass), normalized);
+    EXPECT_EQ(std::string_view(one_pass), normalized);
+    EXPECT_EQ(std::string_view(transliterated), expected);
+    EXPECT_EQ(std::string_view(fused), expected);
+    EXPECT_EQ(std::string_view(read), baybayin_to_latin(expected));
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <baybayin-core/norm.h>
+#include <baybayin-core/pipeline.h>
+#include <baybayin-core/tl.h>
+#include "include/protocol.h"
+
+using namespace baybayin;
+
+static std::string
+respond(const std::string_view line) {
+    Responder responder;
+    std::string out;
+    responder.respond(line, out);
+    return out;
+}
+
+static std::string
+json_string(const std::string_view text) {
+    std::string out;
+    append_json_string(text, out);
+    return out;
+}
+
+TEST(Server, Tools) {
+    EXPECT_EQ(respond(R"({"id": 7, "tool": "tl", "text": "pagmamahal", "orthography": "traditional"})"),
+              R"({"id":7,"text":)" + json_string(latin_to_baybayin("pagmamahal", Orthography::Traditional)) + "}");
+    EXPECT_EQ(respond(R"({"text": "bahay", "virama": "pamudpod"})"),
+              R"({"text":)" + json_string(latin_to_baybayin("bahay", Orthography::Reformed, Virama::Pamudpod)) + "}");
+    EXPECT_EQ(respond(R"({"id": "a", "reverse": true, "text": "ᜊᜑᜌ᜔"})"), R"({"id":"a","text":"bahay"})");
+    EXPECT_EQ(respond(R"({"tool": "norm", "text": "christ xerox", "language": "english"})"),
+              R"({"text":)" + json_string(phil_norm::normalizer("christ xerox", ForeignLanguage::ENGLISH,
+                                                           LatinOrthography::ABAKADA, Diphthong::REFORMED,
+                                                           InitialCluster::REFORMED)) + "}");
+    EXPECT_EQ(respond(R"({"normalize": true, "text": "chocolate", "diphthong": "traditional"})"),
+              R"({"text":)" + json_string(normalize_to_baybayin("chocolate", ForeignLanguage::SPANISH,
+                                                           LatinOrthography::ABAKADA, Diphthong::TRADITIONAL,
+                                                           InitialCluster::REFORMED)) + "}");
+}
+
+TEST(Server, Reused) {
+    // the engines kept between requests follow each request's settings
+    Responder responder;
+    for (const auto language : {"spanish", "english", "english", "spanish"}) {
+        for (const std::string_view tool : {"\"tool\": \"norm\"", "\"normalize\": true"}) {
+            std::string out;
+            responder.respond(std::string("{") + std::string(tool) + R"(, "text": "xerox", "language": ")" +
+                              language + "\"}", out);
+            EXPECT_EQ(out, respond(std::string("{") + std::string(tool) + R"(, "text": "xerox", "language": ")" +
+                               language + "\"}"));
+        }
+    }
+}
+
+TEST(Server, Strings) {
+    EXPECT_EQ(json_string("a\"b\\c\nd\x01"), R"("a\"b\\c\nd\u0001")");
+    Request request;
+    std::string error;
+    ASSERT_TRUE(parse_request(R"({"text": "bñ😀\/\t"})", request, error)) << error;
+    EXPECT_EQ(request.text, "b\xC3\xB1\xF0\x9F\x98\x80/\t");
+    EXPECT_FALSE(parse_request(R"({"text": "\ud83d"})", request, error));
+    EXPECT_FALSE(parse_request(R"({"text": "abc)", request, error));
+}
+
+TEST(Server, Errors) {
+    EXPECT_EQ(respond("bahay"), R"({"error":"expected a JSON object"})");
+    EXPECT_EQ(respond(R"({"id": 3, "text": "x", "orthography": "modern"})"),
+              R"({"id":3,"error":"invalid orthography: modern"})");
+    EXPECT_EQ(respond(R"({"id": 4})"), R"({"id":4,"error":"missing text"})");
+    EXPECT_EQ(respond(R"({"text": "x", "font": "x"})"), R"({"error":"unknown member: font"})");
+    EXPECT_EQ(respond(R"({"id": [1], "text": "x"})"), R"({"error":"invalid value for id"})");
+    for (const std::string_view id : {"nul", "-", "1.2.3", "01", "1.", ".5", "1e", "+1", "--1", "1e+-2"}) {
+        EXPECT_EQ(respond(R"({"id": )" + std::string(id) + R"(, "text": "x"})"), R"({"error":"invalid value for id"})")
+            << id;
+    }
+    EXPECT_EQ(respond(R"({"id": -0.5e+10, "text": ""})"), R"({"id":-0.5e+10,"text":""})");
+    EXPECT_EQ(respond(R"({"id": null, "text": ""})"), R"({"id":null,"text":""})");
+    EXPECT_EQ(respond(R"({"text": "x", "reverse": 1})"), R"({"error":"invalid value for reverse"})");
+    EXPECT_EQ(respond(R"({"tool": "norm", "reverse": true, "text": "x"})"),
+              R"({"error":"reverse cannot be combined with normalize or norm"})");
+    EXPECT_EQ(respond(R"({"text": "x"} {)"), R"({"error":"trailing characters after the request"})");
+}
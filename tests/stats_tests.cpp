@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <baybayin-core/norm.h>
+#include <baybayin-core/tl.h>
+
+// Built with BAYBAYIN_STATS, see tests/CMakeLists.txt
+
+using baybayin::GlyphClass;
+using baybayin::RulePass;
+using baybayin::Stage;
+
+// The index of the rule with pattern and after in rules
+static size_t
+rule_index(const phil_norm::RuleSet &rules, const std::string_view pattern, const std::string_view after = "") {
+    for (size_t r = 0; r < rules.size(); ++r) {
+        if (rules.rule(r).pattern == pattern && rules.rule(r).after == after) {
+            return r;
+        }
+    }
+    ADD_FAILURE() << "no rule " << pattern;
+    return 0;
+}
+
+static uint64_t
+rule_hits(const baybayin::Stats &stats, const RulePass pass, const size_t rule) {
+    return stats.rules[static_cast<size_t>(pass)][rule];
+}
+
+static uint64_t
+glyphs(const baybayin::Stats &stats, const GlyphClass glyph) {
+    return stats.glyphs[static_cast<size_t>(glyph)];
+}
+
+TEST(Stats, RuleHits) {
+    const auto &rules = phil_norm::builtin_language(phil_norm::ForeignLanguage::SPANISH,
+                                                    phil_norm::LatinOrthography::ABAKADA).consonants;
+    EXPECT_EQ(rules.rule(rule_index(rules, "ll")).replacement, "y");
+    const baybayin::Stats before = baybayin::thread_stats();
+    // both engines count the same rules
+    const std::string_view latin = "Caso cine mga llama queso coco";
+    EXPECT_EQ(phil_norm::normalizer(latin, phil_norm::ForeignLanguage::SPANISH, phil_norm::LatinOrthography::ABAKADA,
+                                    phil_norm::Diphthong::REFORMED, phil_norm::InitialCluster::REFORMED),
+              "kaso sine manga yama keso koko");
+    EXPECT_EQ(phil_norm::fast_normalizer(latin, phil_norm::ForeignLanguage::SPANISH,
+                                         phil_norm::LatinOrthography::ABAKADA, phil_norm::Diphthong::REFORMED,
+                                         phil_norm::InitialCluster::REFORMED), "kaso sine manga yama keso koko");
+    const baybayin::Stats &after = baybayin::thread_stats();
+    const auto hits = [&](const std::string_view pattern, const std::string_view after_context = "") {
+        const size_t rule = rule_index(rules, pattern, after_context);
+        return rule_hits(after, RulePass::Consonants, rule) - rule_hits(before, RulePass::Consonants, rule);
+    };
+    EXPECT_EQ(hits("c", "a"), 2u);
+    EXPECT_EQ(hits("c", "o"), 4u);
+    EXPECT_EQ(hits("c"), 2u);
+    EXPECT_EQ(hits("mga", "$"), 2u);
+    EXPECT_EQ(hits("ll"), 2u);
+    EXPECT_EQ(hits("qu"), 2u);
+    EXPECT_EQ(hits("q"), 0u);
+    EXPECT_GT(after.cycles[static_cast<size_t>(Stage::Consonants)],
+              before.cycles[static_cast<size_t>(Stage::Consonants)]);
+}
+
+TEST(Stats, VowelRuleHits) {
+    const auto &rules = phil_norm::builtin_language(phil_norm::ForeignLanguage::ENGLISH,
+                                                    phil_norm::LatinOrthography::ABAKADA).vowels;
+    const baybayin::Stats before = baybayin::thread_stats();
+    EXPECT_EQ(phil_norm::fast_normalizer("rain boat free", phil_norm::ForeignLanguage::ENGLISH,
+                                         phil_norm::LatinOrthography::ABAKADA, phil_norm::Diphthong::REFORMED,
+                                         phil_norm::InitialCluster::REFORMED), "reyn bot pri");
+    const baybayin::Stats &after = baybayin::thread_stats();
+    for (const auto pattern : {"ai", "oa", "ee"}) {
+        const size_t rule = rule_index(rules, pattern);
+        EXPECT_EQ(rule_hits(after, RulePass::Vowels, rule) - rule_hits(before, RulePass::Vowels, rule), 1u)
+            << pattern;
+    }
+    const size_t silent = rule_index(rules, "e", "$");
+    EXPECT_EQ(rule_hits(after, RulePass::Vowels, silent), rule_hits(before, RulePass::Vowels, silent));
+}
+
+TEST(Stats, Glyphs) {
+    const baybayin::Stats before = baybayin::thread_stats();
+    EXPECT_EQ(baybayin::latin_to_baybayin("bata ng, akx 12"), baybayin::latin_to_baybayin("bata ng, ak "));
+    const baybayin::Stats &after = baybayin::thread_stats();
+    EXPECT_EQ(glyphs(after, GlyphClass::Vowel) - glyphs(before, GlyphClass::Vowel), 2u);
+    EXPECT_EQ(glyphs(after, GlyphClass::Syllable) - glyphs(before, GlyphClass::Syllable), 4u);
+    EXPECT_EQ(glyphs(after, GlyphClass::Coda) - glyphs(before, GlyphClass::Coda), 4u);
+    EXPECT_EQ(glyphs(after, GlyphClass::Punctuation) - glyphs(before, GlyphClass::Punctuation), 8u);
+    EXPECT_EQ(glyphs(after, GlyphClass::Skipped) - glyphs(before, GlyphClass::Skipped), 3u);
+}
+
+TEST(Stats, Threads) {
+    const auto &rules = phil_norm::builtin_language(phil_norm::ForeignLanguage::SPANISH,
+                                                    phil_norm::LatinOrthography::ABAKADA).consonants;
+    const size_t rule = rule_index(rules, "ll");
+    const uint64_t own = rule_hits(baybayin::thread_stats(), RulePass::Consonants, rule);
+    const uint64_t total = rule_hits(baybayin::collect_stats(), RulePass::Consonants, rule);
+    // counted on a thread that has exited by the time they are collected
+    std::thread([] {
+        phil_norm::fast_normalizer("llama calle", phil_norm::ForeignLanguage::SPANISH,
+                                   phil_norm::LatinOrthography::ABAKADA, phil_norm::Diphthong::REFORMED,
+                                   phil_norm::InitialCluster::REFORMED);
+    }).join();
+    EXPECT_EQ(rule_hits(baybayin::thread_stats(), RulePass::Consonants, rule), own);
+    EXPECT_EQ(rule_hits(baybayin::collect_stats(), RulePass::Consonants, rule), total + 2);
+}
@@ -1,8 +1,13 @@
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <bit>
+#include <cctype>
 #include <filesystem>
 #include <map>
+#include <random>
+#include <sstream>
 #include <baybayin-core/tl.h>
+#include <baybayin-core/util/parallel.h>
 #include "include/tl_tests.h"
 
 using namespace baybayin;
@@ -50,4 +55,344 @@ INSTANTIATE_TEST_SUITE_P(
     WordsReformedKrus,
     LatinToBaybayinReformedKrus,
     testing::ValuesIn(VocabularyReformed)
-    );
\ No newline at end of file
+    );
+TEST(LatinToBaybayin, Sentences) {
+    // long enough to cross several scan blocks, shifted so every word meets a block boundary
+    for (size_t shift = 0; shift < ScanWidth; ++shift) {
+        std::string latin(shift, '-');
+        std::string traditional, reformed;
+        for (const auto &[word, word_traditional, word_reformed] : TestVocabulary) {
+            latin.append(word).append(" ");
+            traditional.append(word_traditional);
+            reformed.append(word_reformed).append(" ");
+        }
+        EXPECT_EQ(latin_to_baybayin(latin, Orthography::Traditional), traditional) << "shift " << shift;
+        EXPECT_EQ(latin_to_baybayin(latin, Orthography::Reformed), reformed) << "shift " << shift;
+    }
+}
+
+TEST(ScanBlock, KernelsMatchScalar) {
+    std::array<char, 256 + ScanWidth> bytes{};
+    for (size_t b = 0; b < bytes.size(); ++b) {
+        bytes[b] = static_cast<char>(b * 7 % 256);
+    }
+    for (size_t offset = 0; offset + ScanWidth <= bytes.size(); ++offset) {
+        ScanBlock scalar;
+        scan_block_scalar(bytes.data() + offset, ScanWidth, scalar);
+        const auto expect_same = [&](const ScanBlock &block, const char *kernel) {
+            EXPECT_EQ(block.lower, scalar.lower) << kernel << " offset " << offset;
+            EXPECT_EQ(block.masks.vowel, scalar.masks.vowel) << kernel << " offset " << offset;
+            EXPECT_EQ(block.masks.consonant, scalar.masks.consonant) << kernel << " offset " << offset;
+            EXPECT_EQ(block.masks.space, scalar.masks.space) << kernel << " offset " << offset;
+            EXPECT_EQ(block.masks.punctuation, scalar.masks.punctuation) << kernel << " offset " << offset;
+            EXPECT_EQ(block.masks.non_ascii, scalar.masks.non_ascii) << kernel << " offset " << offset;
+        };
+        ScanBlock block;
+        scan_block(bytes.data() + offset, ScanWidth, block);
+        expect_same(block, "dispatch");
+#if defined(__SSE2__)
+        scan_block_sse2(bytes.data() + offset, block);
+        expect_same(block, "sse2");
+#endif
+#if defined(__AVX2__)
+        scan_block_avx2(bytes.data() + offset, block);
+        expect_same(block, "avx2");
+#endif
+    }
+}
+
+TEST(ScanBlock, AsciiPrefix) {
+    // a byte outside ASCII at every position of a few blocks, and none at all
+    std::string text(3 * ScanWidth + 5, 'a');
+    EXPECT_EQ(ascii_prefix(text), text.size());
+    EXPECT_EQ(ascii_prefix(""), 0u);
+    for (size_t pos = 0; pos < text.size(); ++pos) {
+        for (const char high : {'\x80', '\xC3', '\xFF'}) {
+            text[pos] = high;
+            EXPECT_EQ(ascii_prefix(text), pos) << pos;
+            EXPECT_EQ(ascii_prefix(std::string_view(text).substr(pos / 2)), pos - pos / 2) << pos;
+            text[pos] = '~';
+        }
+    }
+}
+
+TEST(LatinToBaybayin, AppendsToBuffer) {
+    std::string out = "ᜊᜌ᜔ᜊᜌᜒᜈ᜔ ";
+    out.reserve(256);
+    const size_t capacity = out.capacity();
+    latin_to_baybayin("pagmamahal", out);
+    EXPECT_EQ(out, "ᜊᜌ᜔ᜊᜌᜒᜈ᜔ ᜉᜄ᜔ᜋᜋᜑᜎ᜔");
+    out.clear();
+    latin_to_baybayin("bahay", out, Orthography::Traditional);
+    EXPECT_EQ(out, "ᜊᜑ");
+    EXPECT_EQ(out.capacity(), capacity);
+}
+
+TEST(LatinToBaybayin, WritesToSpan) {
+    for (const auto &[latin, traditional, reformed] : TestVocabulary) {
+        for (const auto &[ortho, expected] : {std::pair{Orthography::Traditional, traditional},
+                                              std::pair{Orthography::Reformed, reformed}}) {
+            const size_t size = baybayin_output_size(latin, ortho);
+            ASSERT_EQ(size, expected.size()) << latin;
+            std::string out(size, '\0');
+            EXPECT_EQ(latin_to_baybayin(latin, std::span(out), ortho), size) << latin;
+            EXPECT_EQ(out, expected);
+        }
+    }
+}
+
+TEST(LatinToBaybayin, SpanTooSmall) {
+    // ᜊᜑᜌ᜔ is 3 + 3 + 6 bytes, the coda does not fit in 10
+    std::array<char, 10> out{};
+    EXPECT_EQ(latin_to_baybayin("bahay", std::span(out)), 6);
+    EXPECT_EQ(std::string_view(out.data(), 6), "ᜊᜑ");
+}
+
+TEST(LatinToBaybayin, Specialized) {
+    for (const auto &[latin, traditional, reformed] : TestVocabulary) {
+        EXPECT_EQ((latin_to_baybayin<Orthography::Traditional, Virama::Krus>(latin)), traditional);
+        EXPECT_EQ((latin_to_baybayin<Orthography::Reformed, Virama::Krus>(latin)), reformed);
+        EXPECT_EQ((latin_to_baybayin<Orthography::Reformed, Virama::Pamudpod>(latin)),
+                  latin_to_baybayin(latin, Orthography::Reformed, Virama::Pamudpod));
+        EXPECT_EQ((latin_to_baybayin<Orthography::Modern, Virama::Pamudpod>(latin)),
+                  latin_to_baybayin(latin, Orthography::Modern, Virama::Pamudpod));
+    }
+}
+
+class BaybayinToLatinTraditional : public ::testing::TestWithParam<TranslateTestCase> {};
+
+TEST_P(BaybayinToLatinTraditional, RoundTrip) {
+    const auto &[latin, baybayin] = GetParam();
+    const std::string reading = baybayin_to_latin(baybayin);
+    EXPECT_EQ(latin_to_baybayin(reading, Orthography::Traditional), baybayin)
+        << "round trip failed for latin \"" << latin << "\" read as \"" << reading << "\"";
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    WordsTraditional,
+    BaybayinToLatinTraditional,
+    testing::ValuesIn(VocabularyTraditional)
+    );
+
+class BaybayinToLatinReformed : public ::testing::TestWithParam<TranslateTestCase> {};
+
+TEST_P(BaybayinToLatinReformed, RoundTrip) {
+    const auto &[latin, baybayin] = GetParam();
+    const std::string reading = baybayin_to_latin(baybayin);
+    EXPECT_EQ(latin_to_baybayin(reading, Orthography::Reformed), baybayin)
+        << "round trip failed for latin \"" << latin << "\" read as \"" << reading << "\"";
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    WordsReformed,
+    BaybayinToLatinReformed,
+    testing::ValuesIn(VocabularyReformed)
+    );
+
+TEST(BaybayinToLatin, Reading) {
+    EXPECT_EQ(baybayin_to_latin("ᜊᜌ᜔ᜊᜌᜒᜈ᜔"), "baybayin");
+    EXPECT_EQ(baybayin_to_latin("ᜃᜓᜎᜓᜄ᜴"), "kulug");
+    EXPECT_EQ(baybayin_to_latin("ᜀᜅ᜔ ᜊᜑᜌ᜔| ᜋᜅ ᜉᜈᜓ||"), "ang bahay, manga panu.");
+    EXPECT_EQ(baybayin_to_latin("ᜍᜓᜐ᜵ ᜀᜃᜓ᜶"), "rusa, aku.");
+    EXPECT_EQ(baybayin_to_latin("ᜊ 1 ᜊ"), "ba 1 ba");
+}
+
+TEST(StreamingTransliterator, AnyChunkSplit) {
+    constexpr std::string_view alphabet = "aeioubkdghlmnprstwyNGcx ,.-";
+    std::mt19937 random(17);
+    for (size_t round = 0; round < 2000; ++round) {
+        std::string latin(random() % 200, ' ');
+        for (auto &c : latin) {
+            c = alphabet[random() % alphabet.size()];
+        }
+        for (const auto ortho : {Orthography::Traditional, Orthography::Reformed}) {
+            StreamingTransliterator transliterator(ortho);
+            std::string streamed;
+            for (std::string_view rest = latin; !rest.empty();) {
+                // mostly tiny chunks, sometimes ones spanning scan blocks
+                const size_t size = std::min<size_t>(random() % 4 ? random() % 5 : random() % 100, rest.size());
+                transliterator.feed(rest.substr(0, size), streamed);
+                rest.remove_prefix(size);
+            }
+            transliterator.finish(streamed);
+            EXPECT_EQ(streamed, latin_to_baybayin(latin, ortho)) << "split of \"" << latin << "\"";
+        }
+    }
+}
+
+TEST(LatinToBaybayin, Batch) {
+    std::vector<std::string_view> column;
+    for (const auto &entry : VocabularyReformed) {
+        column.push_back(entry.latin);
+    }
+    column.emplace_back("");
+    const auto batch = latin_to_baybayin_batch(column, Orthography::Reformed);
+    ASSERT_EQ(batch.size(), column.size());
+    EXPECT_EQ(batch.offsets.front(), 0);
+    EXPECT_EQ(batch.offsets.back(), batch.data.size());
+    for (size_t i = 0; i < column.size(); ++i) {
+        EXPECT_EQ(batch[i], latin_to_baybayin(column[i], Orthography::Reformed)) << column[i];
+    }
+
+    // a reused batch is refilled in place
+    auto reused = batch;
+    const char *arena = reused.data.data();
+    latin_to_baybayin_batch(std::span(column).subspan(0, 2), reused, Orthography::Reformed);
+    ASSERT_EQ(reused.size(), 2);
+    EXPECT_EQ(reused.data.data(), arena);
+    EXPECT_EQ(reused[1], batch[1]);
+}
+
+TEST(ByteClasses, Locale) {
+    for (int b = 0; b < 256; ++b) {
+        const char c = static_cast<char>(b);
+        const bool ascii = b < 0x80;
+        EXPECT_EQ(is_ascii_space(c), ascii && std::isspace(b)) << b;
+        EXPECT_EQ(is_ascii_letter(c), ascii && std::isalpha(b)) << b;
+        EXPECT_EQ(ascii_lower(c), ascii ? static_cast<char>(std::tolower(b)) : c) << b;
+        EXPECT_EQ(byte_class(c) & BytePunctuation, ascii && std::ispunct(b) ? BytePunctuation : 0) << b;
+        EXPECT_EQ(std::popcount(byte_class(c)), 1) << b;
+    }
+    EXPECT_EQ(byte_class('\xC3'), ByteUtf8Lead);
+    EXPECT_EQ(byte_class('\xB1'), ByteUtf8Continuation);
+}
+
+TEST(Words, Split) {
+    const auto split = [](const std::string_view text, const auto... separators) {
+        std::vector<std::pair<std::string_view, std::string_view>> words;
+        for (const auto &word : Words(text, separators...)) {
+            words.emplace_back(word.word(), word.separators());
+        }
+        return words;
+    };
+    using Split = std::vector<std::pair<std::string_view, std::string_view>>;
+    EXPECT_EQ(split(""), Split{});
+    EXPECT_EQ(split("ang mga, bata"), (Split{{"ang", " "}, {"mga", ", "}, {"bata", ""}}));
+    EXPECT_EQ(split(" (ni\xC3\xB1o2)"), (Split{{"", " ("}, {"ni\xC3\xB1o2", ")"}}));
+    EXPECT_EQ(split("mga, bata ", ByteSpace), (Split{{"mga,", " "}, {"bata", " "}}));
+}
+
+TEST(Words, ForEachWordMatchesWords) {
+    std::mt19937 random(31);
+    for (size_t round = 0; round < 200; ++round) {
+        std::string text;
+        for (size_t size = random() % (4 * ScanWidth); size > 0; --size) {
+            text.push_back(std::array{'a', 'N', ' ', ',', '\n', '\xC3', '7'}[random() % 7]);
+        }
+        std::vector<std::string_view> expected;
+        for (const auto &word : Words(text)) {
+            if (!word.word().empty()) {
+                expected.push_back(word.word());
+            }
+        }
+        std::vector<std::string_view> words;
+        for_each_word(text, [&](const size_t start, const size_t size) {
+            words.push_back(std::string_view(text).substr(start, size));
+        });
+        EXPECT_EQ(words, expected) << text;
+    }
+}
+
+TEST(WordCache, Table) {
+    WordCache cache(3);
+    EXPECT_EQ(cache.capacity(), 4);
+    const auto hash = WordCache::hash(CacheTransliterate, "ang");
+    EXPECT_EQ(cache.find(hash, CacheTransliterate, "ang"), nullptr);
+    cache.insert(hash, CacheTransliterate, "ang", "x", 1);
+    const auto *entry = cache.find(hash, CacheTransliterate, "ang");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->value(), "x");
+    EXPECT_EQ(entry->flags, 1);
+    // another configuration of the same word is another entry
+    EXPECT_EQ(cache.find(WordCache::hash(CacheNormalize, "ang"), CacheNormalize, "ang"), nullptr);
+    EXPECT_EQ(cache.hits(), 1);
+    EXPECT_EQ(cache.misses(), 2);
+
+    // words that do not fit are not stored, and a full table replaces entries
+    const std::string long_word(WordCache::SlotBytes, 'a');
+    cache.insert(WordCache::hash(CacheTransliterate, long_word), CacheTransliterate, long_word, "y");
+    EXPECT_EQ(cache.find(WordCache::hash(CacheTransliterate, long_word), CacheTransliterate, long_word), nullptr);
+    for (const std::string_view word : {"sa", "na", "ko", "mga", "ng", "ay"}) {
+        cache.insert(WordCache::hash(CacheTransliterate, word), CacheTransliterate, word, word);
+    }
+    EXPECT_NE(cache.find(WordCache::hash(CacheTransliterate, "ay"), CacheTransliterate, "ay"), nullptr);
+
+    WordCache off(0);
+    EXPECT_TRUE(off.bypass(1));
+    off.insert(hash, CacheTransliterate, "ang", "x");
+    EXPECT_EQ(off.find(hash, CacheTransliterate, "ang"), nullptr);
+}
+
+TEST(LatinToBaybayin, Cached) {
+    std::mt19937 random(29);
+    std::vector<std::string> lines;
+    for (size_t line = 0; line < 100; ++line) {
+        std::string text;
+        for (size_t word = random() % 12; word > 0; --word) {
+            text.append(VocabularyReformed[random() % 40].latin);
+            text.append(std::array{" ", " ", ", ", "-", "  ", ". ", "\xC3\xB1"}[random() % 7]);
+        }
+        lines.push_back(random() % 2 ? text : text + "NG");
+    }
+    lines.emplace_back(WordCache::SlotBytes + 1, 'a');
+    lines.emplace_back("");
+    for (const auto ortho : {Orthography::Traditional, Orthography::Reformed, Orthography::Modern}) {
+        for (const auto style : {Virama::Krus, Virama::Pamudpod}) {
+            WordCache cache(1024);
+            for (size_t pass = 0; pass < 2; ++pass) {
+                for (const auto &line : lines) {
+                    std::string cached = "before ";
+                    latin_to_baybayin(line, cached, cache, ortho, style);
+                    EXPECT_EQ(cached, "before " + latin_to_baybayin(line, ortho, style)) << line;
+                }
+            }
+            EXPECT_GT(cache.hits(), cache.misses());
+        }
+    }
+}
+
+TEST(ProcessLinesParallel, MatchesSequential) {
+    std::mt19937 random(41);
+    for (const std::string_view ending : {"", "\n", "\n\n"}) {
+        std::string input, expected;
+        for (size_t line = 0; line < 300; ++line) {
+            const auto &entry = VocabularyReformed[random() % VocabularyReformed.size()];
+            const std::string text(random() % 5 ? entry.latin : "");
+            input.append(text).push_back('\n');
+            expected.append(latin_to_baybayin(text)).push_back('\n');
+        }
+        input.pop_back();
+        input.append(ending);
+        if (!ending.empty()) {
+            expected.append(ending.size() - 1, '\n');
+        }
+        // blocks smaller than a line, of a few lines, and of everything
+        for (const size_t block_size : {1, 7, 64, 1 << 20}) {
+            for (const size_t threads : {1, 3}) {
+                std::istringstream istream(input);
+                std::ostringstream ostream;
+                ASSERT_TRUE(process_lines_parallel(istream, ostream, threads, [] {
+                    return [](const std::string_view line, std::string &out) { latin_to_baybayin(line, out); };
+                }, block_size));
+                EXPECT_EQ(ostream.str(), expected) << block_size << " " << threads;
+                std::string written;
+                ASSERT_TRUE(process_lines_parallel(std::string_view(input), [&](const std::string &output) {
+                    written.append(output);
+                    return true;
+                }, threads, [] {
+                    return [](const std::string_view line, std::string &out) { latin_to_baybayin(line, out); };
+                }, block_size));
+                EXPECT_EQ(written, expected) << block_size << " " << threads;
+            }
+            // text in memory is cut into views of itself, at line ends
+            std::string_view text(input), block;
+            std::string joined;
+            while (next_lines(text, block, block_size)) {
+                EXPECT_TRUE(block.data() >= input.data() && block.data() + block.size() <= input.data() + input.size());
+                EXPECT_TRUE(block.ends_with('\n') || text.empty());
+                joined.append(block);
+            }
+            EXPECT_EQ(joined, input);
+        }
+    }
+}